@@ -0,0 +1,48 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_ARENA_H
+#define ARIS_PL_ARENA_H
+
+#include <stddef.h>
+
+// A bump allocator which owns the wffs and their strings for the lifetime of a script: the
+// objects are carved out of large chunks, and are all released at once when the arena is freed
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct {
+    ArenaChunk *chunks;
+    size_t used;
+    size_t reserved;
+} Arena;
+
+Arena *create_arena();
+
+// releases the arena and every object allocated from it
+void free_arena(Arena *arena);
+
+void *arena_alloc(Arena *arena, size_t size);
+
+char *arena_strdup(Arena *arena, const char *str);
+
+// moves the objects of an arena into another one, which then releases them, and frees the first
+// arena, e.g., when a thread which allocated objects shared with others ends
+void merge_arena(Arena *into, Arena *from);
+
+// the bytes handed out by the arena, and the bytes of its chunks
+size_t arena_bytes_used(const Arena *arena);
+
+size_t arena_bytes_reserved(const Arena *arena);
+
+// Sets the arena of the calling thread, from which the wffs are allocated, or NULL to allocate
+// them with malloc. The wffs allocated from an arena must not be passed to free_wff
+void set_arena(Arena *arena);
+
+Arena *get_arena();
+
+// allocates from the arena of the calling thread, if any, or with malloc
+void *scoped_alloc(size_t size);
+
+char *scoped_strdup(const char *str);
+
+#endif //ARIS_PL_ARENA_H
@@ -0,0 +1,65 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_BDD_H
+#define ARIS_PL_BDD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "wff.h"
+
+// Reduced ordered binary decision diagrams with complement edges. All the BDDs of a thread share
+// one unique table, so that equal functions are the same edge, and one computed table which
+// caches the results of if-then-else. The variables are the atoms, ordered by their identifiers
+// in the symbol table.
+//
+// A BDD is an edge: the index of its node shifted left by one, with the lowest bit set if the
+// edge is complemented. The only terminal is the node 0, hence true is the edge 0, and false is
+// its complement. The high edge of a node is never complemented
+typedef uint32_t Bdd;
+
+#define BDD_TRUE ((Bdd) 0)
+#define BDD_FALSE ((Bdd) 1)
+
+// the maximum number of nodes, beyond which the operations give up
+#define MAX_BDD_NODES (1u << 22)
+
+static inline Bdd bdd_not(Bdd f) {
+    return f ^ 1;
+}
+
+Bdd bdd_var(int atom);
+
+Bdd bdd_ite(Bdd f, Bdd g, Bdd h);
+
+Bdd bdd_and(Bdd f, Bdd g);
+
+Bdd bdd_or(Bdd f, Bdd g);
+
+Bdd bdd_implies(Bdd f, Bdd g);
+
+// compiles a wff, and returns its BDD with one reference
+Bdd bdd_from_wff(Wff *wff);
+
+// The nodes are reference counted: bdd_ref protects a BDD, and its nodes, from the garbage
+// collection, which frees the nodes that no referenced BDD reaches. The results of the
+// operations have no reference
+void bdd_ref(Bdd f);
+
+void bdd_deref(Bdd f);
+
+void bdd_gc();
+
+// the number of live nodes, the terminal included
+size_t bdd_node_count();
+
+// true if an operation gave up because of MAX_BDD_NODES since the last reset
+bool bdd_limit_reached();
+
+void bdd_reset_limit();
+
+// releases the nodes and the tables of the calling thread, and with them all its BDDs
+void bdd_clear();
+
+#endif //ARIS_PL_BDD_H
@@ -0,0 +1,39 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_CNF_H
+#define ARIS_PL_CNF_H
+
+#include <glib.h>
+#include "sat.h"
+#include "wff.h"
+
+// A formula in conjunctive normal form, as a list of clauses of DIMACS literals, each clause
+// being terminated by 0. The variables from 1 to n_vars are either atoms, whose names are in
+// names, or the auxiliary variables of the Tseitin encoding, whose names are NULL. atoms maps
+// the identifier of an atom to its variable, or 0, and ids maps the canonical identifier of a
+// wff built by the unique table to its variable
+typedef struct {
+    int n_vars;
+    size_t n_clauses;
+    GArray *literals;
+    GArray *atoms;
+    GPtrArray *names;
+    GHashTable *nodes;
+    GHashTable *ids;
+} Cnf;
+
+Cnf *create_cnf();
+
+void free_cnf(Cnf *cnf);
+
+void add_clause(Cnf *cnf, const int *literals, size_t n);
+
+// Tseitin encoding: every binary wff gets a variable which is equivalent to it, hence the size of
+// the clauses is linear in the size of the wff. Returns the literal which is equivalent to the wff
+int encode_wff(Cnf *cnf, Wff *wff);
+
+// adds the clauses to the solver, allocating its variables if needed
+bool load_cnf(Solver *solver, const Cnf *cnf);
+
+#endif //ARIS_PL_CNF_H
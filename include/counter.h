@@ -0,0 +1,20 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_COUNTER_H
+#define ARIS_PL_COUNTER_H
+
+#include "wff.h"
+
+// A model counter: the wffs are Tseitin-encoded, which leaves the number of models unchanged as
+// the auxiliary variables are defined by the atoms, and the clauses are counted by DPLL. After
+// the unit propagation, the variables which no clause mentions double the count, the clauses are
+// split into components which share no variable, whose counts multiply, and a component is split
+// on its most frequent variable, whose two counts add. The count of every component is cached,
+// hence the components which recur on many branches are counted once. The counts are exact.
+//
+// Counts the valuations of the atoms of an argument which satisfy all its premises, and those of
+// them which falsify its conclusion, as decimal strings, and the number of atoms
+void count_argument(Wff *argument, char **models, char **counterexamples, int *n_atoms);
+
+#endif //ARIS_PL_COUNTER_H
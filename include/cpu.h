@@ -0,0 +1,17 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_CPU_H
+#define ARIS_PL_CPU_H
+
+#include <stdbool.h>
+
+// Runtime detection of the vector extensions of the host; always false on other architectures
+
+bool cpu_supports_sse42();
+
+bool cpu_supports_avx2();
+
+bool cpu_supports_avx512();
+
+#endif //ARIS_PL_CPU_H
@@ -0,0 +1,28 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_DIMACS_H
+#define ARIS_PL_DIMACS_H
+
+#include <stdio.h>
+#include "wff.h"
+
+// Writes the Tseitin encoding of the premises and of the negated conclusion of an argument, which
+// is unsatisfiable if the argument is valid, in the DIMACS CNF format. A tautology, i.e., an
+// argument without a conclusion, is written as its negated formula. The names of the atoms are
+// in comments like "c atom 3 P", which read_dimacs reads back
+void write_dimacs(FILE *file, Wff *argument);
+
+// Reads a DIMACS CNF file into an argument whose premises are the clauses, as disjunctions of
+// literals, and which has no conclusion. A variable is the atom of its comment, if any, or else
+// Xn for the variable n. Returns NULL, and sets the error, if the file is malformed, e.g., if a
+// literal is not one of the variables of the header, or if the number of clauses is not the one
+// of the header
+Wff *read_dimacs(FILE *file, char **error);
+
+// Reads the DIMACS CNF file at the path into an argument whose premises are the clauses, and whose
+// conclusion is a contradiction, hence the argument is valid if and only if the clauses are
+// unsatisfiable
+Wff *load_dimacs(const char *path, char **error);
+
+#endif //ARIS_PL_DIMACS_H
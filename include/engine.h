@@ -0,0 +1,48 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_ENGINE_H
+#define ARIS_PL_ENGINE_H
+
+#include <glib.h>
+#include <stdbool.h>
+#include "wff.h"
+
+// The decision procedures behind is_valid and is_tautology: the truth-table sweep, the CDCL
+// solver over the Tseitin encoding, the BDDs, which share their nodes across the whole run, and
+// the semantic tableau, whose branches are expanded by as many threads as the sweep.
+// The automatic choice sweeps the truth table of small sets of formulae, and gives the others
+// to the solver
+typedef enum {
+    ENGINE_AUTO,
+    ENGINE_BDD,
+    ENGINE_SAT,
+    ENGINE_TABLEAU,
+    ENGINE_TRUTH_TABLE
+} Engine;
+
+// the maximum number of atoms whose truth table is swept by ENGINE_AUTO
+#define AUTO_SWEEP_ATOMS 20
+
+void set_engine(Engine engine);
+
+Engine get_engine();
+
+// parses the name of an engine, i.e., auto, bdd, sat, table, or tableau
+bool engine_from_string(const char *name, Engine *engine);
+
+// if true, is_satisfiable reports on the standard error how much every formula was simplified
+void set_simplification_report(bool report);
+
+// returns true if some assignment of the atoms makes all the formulae true. The formulae are
+// simplified before they are given to the engine
+bool is_satisfiable(GSList *formulae, char **error);
+
+// The wffs built by the unique table are given to one incremental solver, which is shared by all
+// the checks of a thread, so that the premises of several arguments are encoded once, and what
+// the solver learns about them is reused. Every thread of a pool has its own session, which lasts
+// as long as the pool. The session of the calling thread ends, and it must end before the unique
+// table is cleared
+void end_solver_session();
+
+#endif //ARIS_PL_ENGINE_H
@@ -0,0 +1,27 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_EVALUATOR_H
+#define ARIS_PL_EVALUATOR_H
+
+#include <stdbool.h>
+#include "symbols.h"
+#include "wff.h"
+
+// A wff, or an argument, compiled for repeated valuations into a flat list of atom tests, each of
+// which jumps to the next test, or to the result, according to the value of its atom. Hence the
+// operators short-circuit, and the operands of &, |, and -> are tested in the order which costs
+// the fewest tests on average, assuming that every atom is true half of the times. A wff over a
+// few atoms is valuated by a lookup in its truth table instead, and on x86-64 a larger one by its
+// machine code, which reads the values of the atoms without a branch
+typedef struct Evaluator Evaluator;
+
+Evaluator *compile_evaluator(Wff *wff);
+
+void free_evaluator(Evaluator *evaluator);
+
+// Valuates the wff as valuate does: if some atom of the wff has no value, the wff is walked by
+// valuate, which reports the missing atom
+bool run_evaluator(const Evaluator *evaluator, const Valuation *values, char **error);
+
+#endif //ARIS_PL_EVALUATOR_H
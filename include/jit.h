@@ -0,0 +1,32 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_JIT_H
+#define ARIS_PL_JIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "program.h"
+
+// A program translated to x86-64 machine code, in a page of its own, which needs no compiler: the
+// top of the stack of lanes is kept in a register, the rest of it on the native stack, the atoms
+// are loaded from memory, and every operator is one or two bitwise instructions, without a branch
+typedef struct Jit Jit;
+
+// where the lanes of the atoms are loaded from: the column of their slot, as in run_program, or the
+// bit of their identifier in a bitset, e.g., the values of a Valuation, which is then the bit 0 of
+// the result
+typedef enum {
+    JIT_COLUMNS,
+    JIT_BITS
+} JitLoads;
+
+// returns NULL on other architectures, or if the page cannot be mapped; the callers then run the
+// program as before
+Jit *compile_jit(const Program *program, JitLoads loads);
+
+void free_jit(Jit *jit);
+
+uint64_t run_jit(const Jit *jit, const uint64_t *words);
+
+#endif //ARIS_PL_JIT_H
@@ -5,11 +5,26 @@
 #define ARIS_PL_LEXICAL_ANALYZER_H
 
 #include <glib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "token.h"
 
-#define MAX_LINE 1024
+// The text of a script: a regular file is mapped into memory, and the other streams, e.g., pipes,
+// are read at once. The tokens point into the text, hence it must outlive them
+typedef struct {
+    const char *text;
+    size_t length;
+    bool mapped;
+} Source;
 
-GQueue *tokenize(FILE *file, char** error);
+Source *open_source(FILE *file, char **error);
 
-GQueue *tokenize_string(const char* str, char** error);
+void free_source(Source *source);
+
+// Tokenizes the lines of the text, which can be of any length, without copying them: the atoms
+// are interned, and every line which has tokens is a statement of the stream
+TokenStream *tokenize(const char *text, size_t length, char** error);
+
+TokenStream *tokenize_string(const char* str, char** error);
 
 #endif
@@ -5,8 +5,9 @@
 #define ARIS_PL_PARSER_H
 
 #include <glib.h>
+#include "token.h"
 #include "wff.h"
 
-int parse(GQueue *all_tokens);
+int parse(const TokenStream *stream);
 
 #endif
@@ -0,0 +1,33 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_POOL_H
+#define ARIS_PL_POOL_H
+
+#include <glib.h>
+#include <stdbool.h>
+
+// A pool of threads which run the jobs in the order of their submission, each job on whichever
+// thread is free. Every thread allocates from its own arena, which is merged into the arena of the
+// creator of the pool when the pool is freed, hence the wffs which the jobs build live as long as
+// the others. The cached truth tables are shared by the threads, but the solver session and the
+// BDDs are kept per thread, since a lock would let a single decision run at a time: they are reused
+// by all the jobs of a thread, and released when the pool is freed. The sweeps of a job run on its
+// thread alone
+typedef struct Pool Pool;
+
+typedef void (*JobFunc)(gpointer job);
+
+Pool *create_pool(int n_threads, JobFunc run);
+
+// returns the ticket of the job, i.e., the number of the jobs submitted before it
+int submit_job(Pool *pool, gpointer job);
+
+bool job_done(Pool *pool, int ticket);
+
+void wait_job(Pool *pool, int ticket);
+
+// runs the pending jobs, and then ends the threads
+void free_pool(Pool *pool);
+
+#endif //ARIS_PL_POOL_H
@@ -0,0 +1,48 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_PROGRAM_H
+#define ARIS_PL_PROGRAM_H
+
+#include <glib.h>
+#include <stdint.h>
+#include "wff.h"
+
+typedef enum {
+    OP_AND,
+    OP_ATOM,
+    OP_CONDITIONAL,
+    OP_NOT,
+    OP_OR,
+} OpCode;
+
+typedef struct {
+    OpCode op;
+    int slot;
+} Instruction;
+
+// A wff lowered to a flat postfix program: every atom is replaced by a slot, i.e., the index of
+// its column, and the operators pop their operands from a stack of 64-bit lanes, so that one
+// execution valuates the wff for 64 assignments at once. slots maps the identifier of an atom to
+// its slot, or -1, and atoms maps a slot back to the identifier
+typedef struct {
+    Instruction *code;
+    size_t length;
+    size_t capacity;
+    size_t depth;
+    size_t max_depth;
+    GArray *slots;
+    GArray *atoms;
+} Program;
+
+Program *create_program();
+
+void free_program(Program *program);
+
+void emit_wff(Program *program, Wff *wff);
+
+void emit_operator(Program *program, OpCode op);
+
+uint64_t run_program(const Program *program, const uint64_t *columns, uint64_t *stack);
+
+#endif //ARIS_PL_PROGRAM_H
@@ -0,0 +1,38 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_SAT_H
+#define ARIS_PL_SAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// A conflict-driven clause-learning SAT solver: two watched literals per clause, VSIDS
+// decisions with phase saving, first-UIP learning, Luby restarts and reduction of the learnt
+// clauses. Variables and literals are numbered as in DIMACS: a variable is a positive integer,
+// and its negation is the negative integer
+typedef struct Solver Solver;
+
+Solver *create_solver();
+
+void free_solver(Solver *solver);
+
+// allocates a new variable, and returns its number
+int solver_new_var(Solver *solver);
+
+int solver_n_vars(const Solver *solver);
+
+// adds a clause, and returns false if the clauses are now trivially unsatisfiable
+bool solver_add_clause(Solver *solver, const int *literals, size_t n);
+
+// returns true if the clauses are satisfiable
+bool solver_solve(Solver *solver);
+
+// returns true if the clauses are satisfiable together with the assumed literals, which hold only
+// during this solve. Clauses can be added, and the learnt ones are kept, between the solves
+bool solver_solve_assuming(Solver *solver, const int *assumptions, size_t n);
+
+// the value of a variable in the model found by the last successful solver_solve
+bool solver_model_value(const Solver *solver, int var);
+
+#endif //ARIS_PL_SAT_H
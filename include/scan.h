@@ -0,0 +1,45 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_SCAN_H
+#define ARIS_PL_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// The kernels which find the ends of the lines, the comments, and the ends of the runs of
+// characters of the lexer: the scalar one reads a byte at a time, the SSE4.2 one 16 bytes, and
+// the AVX2 one 32 bytes. A vector is loaded only within the text, hence the text needs no
+// padding, e.g., when it is mapped from a file
+typedef enum {
+    SCAN_SCALAR,
+    SCAN_SSE42,
+    SCAN_AVX2
+} ScanKernel;
+
+// the runs which the lexer reads at once: spaces and tabs, the rest of an atom, of a lower case
+// word, and of a string
+typedef enum {
+    RUN_SPACES,
+    RUN_ATOM,
+    RUN_WORD,
+    RUN_STRING,
+    N_RUNS
+} Run;
+
+// selects the widest kernel supported by the host
+void init_scan();
+
+// selects the given kernel, or returns false if the host does not support it
+bool set_scan_kernel(ScanKernel kernel);
+
+ScanKernel get_scan_kernel();
+
+// Returns the length of the line at the beginning of the text, with its newline if any, and
+// stores in comment the position of the first "//" of the line, or its length
+size_t scan_line(const char *text, size_t length, size_t *comment);
+
+// returns the position of the first character of the text, from i, which is not in the run, or end
+size_t skip_run(Run run, const char *text, size_t i, size_t end);
+
+#endif //ARIS_PL_SCAN_H
@@ -0,0 +1,22 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_SIMPLIFY_H
+#define ARIS_PL_SIMPLIFY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "wff.h"
+
+// Rewrites a wff into an equivalent one, built by the unique table, until nothing changes: the
+// negations are pushed down to the atoms, by De Morgan's laws, and the conditionals become
+// disjunctions, then the double negations, the repeated operands of & and |, the operands which
+// absorb each other, e.g., P | (P & Q), and the complementary ones, e.g., P & !P, are removed.
+// The subformulae which are found true or false are folded into their parents.
+// Returns NULL if the whole wff is true or false, which is then the value
+Wff *simplify_wff(Wff *wff, bool *value);
+
+// the number of operators and atoms of a wff, as it is written
+size_t wff_size(const Wff *wff);
+
+#endif //ARIS_PL_SIMPLIFY_H
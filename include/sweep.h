@@ -0,0 +1,47 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_SWEEP_H
+#define ARIS_PL_SWEEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "program.h"
+
+// The kernels which run a program over the blocks of 64 rows: the scalar one runs one block
+// at a time, the AVX2 one four blocks, and the AVX-512 one eight blocks
+typedef enum {
+    SWEEP_SCALAR,
+    SWEEP_AVX2,
+    SWEEP_AVX512
+} SweepKernel;
+
+// rows are indexed by 64-bit integers, hence the sweep supports at most 64 atoms
+#define MAX_SWEEP_ATOMS 64
+
+// selects the widest kernel supported by the host
+void init_sweep();
+
+// selects the given kernel, or returns false if the host does not support it
+bool set_sweep_kernel(SweepKernel kernel);
+
+SweepKernel get_sweep_kernel();
+
+// sets the number of threads which share a sweep, 0 meaning one per processor
+void set_sweep_threads(int n);
+
+// overrides the number of threads for the sweeps of the calling thread, e.g., 1 for the threads
+// of a pool which already keeps the processors busy, or 0 to follow set_sweep_threads
+void set_local_sweep_threads(int n);
+
+int get_sweep_threads();
+
+// Sweeps all the assignments of the program's atoms, 64 rows at a time, and stops at the first
+// row which makes the program true. In a row, the atom in slot j has the value of the j-th bit
+// of the row's index. The blocks of 64 rows are enumerated in Gray-code order, so that a single
+// set of columns is updated by flipping one atom per block, whatever the number of atoms. Large
+// sweeps are split into chunks of blocks, which are claimed by the threads in turn until one of
+// them finds a row. Returns true if such a row was found, and stores its index in row
+bool sweep_program(const Program *program, uint64_t *row);
+
+#endif //ARIS_PL_SWEEP_H
@@ -0,0 +1,48 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_SYMBOLS_H
+#define ARIS_PL_SYMBOLS_H
+
+#include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// The symbol table gives every distinct atom a dense identifier, from 0, the first time that the
+// lexical analyzer or a wff meets it. The names are owned by the table, and live until the end of
+// the program. The table is shared by all the threads
+int intern_atom(const char *name);
+
+// interns the name of the given length, which need not be terminated, e.g., a span of a script:
+// the span is looked up as it is, and copied only if it is a new name
+int intern_atom_span(const char *name, size_t length);
+
+const char *atom_name(int atom);
+
+// the number of atoms interned so far
+int count_atoms();
+
+// A valuation is a pair of bitsets indexed by the identifiers of the atoms: the atoms which have
+// been assigned a value, and their values
+typedef struct {
+    uint64_t *assigned;
+    uint64_t *values;
+    size_t words;
+} Valuation;
+
+Valuation *create_valuation();
+
+void free_valuation(Valuation *valuation);
+
+void set_atom_value(Valuation *valuation, int atom, bool value);
+
+static inline bool has_atom_value(const Valuation *valuation, int atom) {
+    size_t word = (size_t) atom >> 6;
+    return word < valuation->words && (valuation->assigned[word] >> (atom & 63)) & 1;
+}
+
+static inline bool get_atom_value(const Valuation *valuation, int atom) {
+    return (valuation->values[(size_t) atom >> 6] >> (atom & 63)) & 1;
+}
+
+#endif //ARIS_PL_SYMBOLS_H
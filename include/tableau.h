@@ -0,0 +1,18 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_TABLEAU_H
+#define ARIS_PL_TABLEAU_H
+
+#include <glib.h>
+#include <stdbool.h>
+
+// A semantic tableau, or truth tree, over signed wffs, i.e., wffs which are claimed to be true or
+// false. The non-branching rules are applied first, a branch closes as soon as it makes an atom
+// both true and false, and the tree is open as soon as a branch is saturated without closing.
+// The branches are shared by the threads of a work-stealing pool: every thread expands its own
+// branches depth-first, and takes the oldest branch of another thread when it runs out of them.
+// Returns true if the tree of the formulae, which are all claimed to be true, has an open branch
+bool tableau_satisfiable(GSList *formulae, int n_threads);
+
+#endif //ARIS_PL_TABLEAU_H
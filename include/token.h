@@ -3,6 +3,7 @@
  */
 #include <glib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifndef ARIS_PL_TOKEN_H
 #define ARIS_PL_TOKEN_H
@@ -14,6 +15,8 @@ typedef enum {
     TOKEN_ASSIGN,
     TOKEN_ATOM,
     TOKEN_COMMA,
+    TOKEN_COUNT,
+    TOKEN_EXPORT,
     TOKEN_FALSE,
     TOKEN_IDENTIFIER,
     TOKEN_LEFT_BRACKET,
@@ -29,54 +32,61 @@ typedef enum {
     TOKEN_VALUATE
 } TokenType;
 
+// A token, as read from a TokenStream. Its text is a span, which is not terminated: identifiers,
+// strings, and atoms point into the script, and the other tokens to their spelling, e.g., "=>"
+// for therefore. The atom of a TOKEN_ATOM is its identifier in the symbol table, and -1 for the
+// other tokens
 typedef struct {
     TokenType type;
-    char *value;
+    const char *text;
+    size_t length;
+    int atom;
 } Token;
 
-Token *create_and_token();
-
-Token *create_argument_token();
-
-Token *create_assert_token();
-
-Token *create_assign_token();
-
-Token *create_atom_token(const char *value);
-
-Token *create_comma_token();
-
-Token *create_false_token();
-
-Token *create_identifier_token(const char *value);
-
-Token *create_left_bracket_token();
-
-Token *create_material_implication_token();
-
-Token *create_not_token();
-
-Token *create_or_token();
-
-Token *create_print_token();
+// The tokens of a script, in parallel arrays which grow together instead of an allocation per
+// token: their types, their spans in the text, and the identifiers of their atoms, or -1. The
+// statements are ranges of tokens: the i-th one begins at statements[i], and ends where the
+// next one begins, i.e., there are n_statements + 1 bounds
+typedef struct {
+    const char *text;
+    uint8_t *types;
+    uint32_t *offsets;
+    uint32_t *lengths;
+    int32_t *atoms;
+    size_t n_tokens;
+    size_t capacity;
+    uint32_t *statements;
+    size_t n_statements;
+    size_t statements_capacity;
+} TokenStream;
+
+// reads the tokens of a statement in order
+typedef struct {
+    const TokenStream *stream;
+    size_t next;
+    size_t end;
+} TokenCursor;
 
-Token *create_right_bracket_token();
+TokenStream *create_token_stream(const char *text);
 
-Token *create_string_token(const char *value);
+void add_token(TokenStream *stream, TokenType type, size_t offset, size_t length, int atom);
 
-Token *create_therefore_token();
+// closes the statement of the tokens added since the previous one, if any
+void end_statement(TokenStream *stream);
 
-Token *create_true_token();
+Token get_token(const TokenStream *stream, size_t i);
 
-Token *create_validate_token();
+void free_token_stream(TokenStream *stream);
 
-Token *create_valuate_token();
+TokenCursor statement_cursor(const TokenStream *stream, size_t statement);
 
-bool can_follow(const Token *current, const Token *next);
+// reads the next token of the statement, if any, into the token, which can be NULL
+bool peek_token(const TokenCursor *cursor, Token *token);
 
-void free_token(Token *token);
+// like peek_token, and moves past the token
+bool pop_token(TokenCursor *cursor, Token *token);
 
-void free_token_func(gpointer data);
+bool can_follow(TokenType current, TokenType next);
 
 const char *token_type_to_str(TokenType type);
 
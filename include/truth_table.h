@@ -0,0 +1,44 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_TRUTH_TABLE_H
+#define ARIS_PL_TRUTH_TABLE_H
+
+#include <glib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "symbols.h"
+#include "wff.h"
+
+// the truth table of 16 atoms takes 1024 words, i.e., 8 KiB
+#define MAX_TABLE_ATOMS 16
+
+// The truth function of a conjunction of wffs over a few atoms, as a bit vector: the bit of a row
+// is the value of the conjunction, where the atom in slot j has the value of the j-th bit of the
+// row. The atoms are in the slots in the order of their identifiers, and the table of up to six
+// atoms is a single word. The tables are built bottom-up: an atom is a projection mask, and every
+// operator is applied word by word to the tables of its operands. The tables of the wffs which
+// were built by the unique table are cached, by their canonical identifier and their atoms, hence
+// the subformulae which are shared by many arguments over the same atoms are built once
+typedef struct {
+    int n_atoms;
+    int atoms[MAX_TABLE_ATOMS];
+    size_t n_words;
+    uint64_t *words;
+} TruthTable;
+
+// returns NULL if the formulae have more than MAX_TABLE_ATOMS atoms
+TruthTable *create_truth_table(GSList *formulae);
+
+void free_truth_table(TruthTable *table);
+
+bool truth_table_satisfiable(const TruthTable *table);
+
+// the value of the row of the valuation, which must give a value to all the atoms of the table
+bool truth_table_value(const TruthTable *table, const Valuation *values);
+
+// forgets the cached tables of all the threads, e.g., before the unique table is cleared; no other
+// thread may be building a table meanwhile
+void clear_truth_tables();
+
+#endif //ARIS_PL_TRUTH_TABLE_H
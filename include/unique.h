@@ -0,0 +1,28 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_UNIQUE_H
+#define ARIS_PL_UNIQUE_H
+
+#include <glib.h>
+#include "wff.h"
+
+// The unique table hash-conses the wffs built by the parser, so that structurally equal wffs are
+// the same node, printed as they were written. Every node also gets a canonical identifier, which
+// is the same for the wffs which only differ in the order of the operands of & and |
+Wff *unique_atomic_condition(int atom);
+
+Wff *unique_negation(Wff *wff1);
+
+// type is one of WFF_CONDITIONAL, WFF_CONJUNCTION, and WFF_DISJUNCTION
+Wff *unique_binary(WffType type, Wff *wff1, Wff *wff2);
+
+// forgets the nodes, e.g., before the arena which holds them is freed
+void clear_unique_table();
+
+// The canonical key of an argument, made of the set of the identifiers of its premises and of
+// the identifier of its conclusion, if any, or NULL if any of them was not built by the unique
+// table
+char *argument_key(const Wff *argument);
+
+#endif //ARIS_PL_UNIQUE_H
@@ -0,0 +1,39 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#ifndef ARIS_PL_VERDICT_CACHE_H
+#define ARIS_PL_VERDICT_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "wff.h"
+
+// A persistent cache of the verdicts of validate and assert, in a file which is memory-mapped,
+// so that the next runs of a script answer from it. An argument is keyed by a 128-bit hash of
+// its canonical form: the premises are a set, the atoms are colored by the places where they
+// occur, the premises and the operands of & and | are sorted by their shapes under those colors,
+// and the atoms are renamed in the order in which they appear. Hence the arguments which only
+// differ in the names of their atoms, and in the order of the operands, mostly share their
+// verdict, while two arguments with the same canonical form are always equivalent.
+//
+// The file has a fixed number of slots, and a key can only be in the few slots after its home
+// one: when they are all taken, the least recently used is overwritten. Every slot carries a
+// checksum, hence a slot which is torn by a crash, or by another process, is just a miss
+#define VERDICT_CACHE_SLOTS (1u << 16)
+
+// opens the cache file, creating it if needed, and returns false if it cannot be mapped, or if it
+// is a non-empty file which is not a verdict cache, which is then left untouched
+bool open_verdict_cache(const char *path, char **error);
+
+void close_verdict_cache();
+
+// command is "t" for assert and "v" for validate; returns false if the verdict is unknown, or no
+// cache is open
+bool lookup_verdict(const char *command, const Wff *argument, bool *verdict);
+
+void store_verdict(const char *command, const Wff *argument, bool verdict);
+
+// the canonical form of an argument, which the cache hashes, e.g., "v(a0 & a1)=>a0"
+char *canonical_argument(const char *command, const Wff *argument);
+
+#endif //ARIS_PL_VERDICT_CACHE_H
@@ -5,6 +5,8 @@
 #define ARIS_PL_WFF_H
 
 #include <stdbool.h>
+#include "symbols.h"
+#include "token.h"
 
 typedef enum {
     WFF_ARGUMENT,
@@ -25,14 +27,18 @@ typedef struct WellFormedFormula Wff;
 //
 // In the case of an atomic condition, wff1 represent the unitary condition
 // In the case of a binary condition, wff1 and wff2 represent the two conditions
+//
+// An atomic wff holds the identifier of its atom in the symbol table, and its value is the
+// name owned by the table. The wffs built by the parser are shared through the unique table,
+// and id is their canonical identifier, or -1 for the others
 struct WellFormedFormula {
     WffType type;
     Wff *wff1;
     Wff *wff2;
     GSList *premises;
-    GSList *falsehood_conditions;
-    GSList *truth_conditions;
     char *value;
+    int atom;
+    int id;
     bool b_value;
 };
 
@@ -42,6 +48,8 @@ Wff *create_argument();
 
 Wff *create_atomic_condition(const char *value);
 
+Wff *create_interned_atomic_condition(int atom);
+
 Wff *create_binary_condition(Wff *wff1, Wff *wff2);
 
 Wff *create_conditional(Wff *wff1, Wff *wff2);
@@ -68,9 +76,9 @@ bool is_tautology(Wff *wff, char **error);
 
 bool is_valid(Wff *arg, char **error);
 
-Wff *parse_wff(GQueue *tokens, char **error);
+Wff *parse_wff(TokenCursor *tokens, char **error);
 
-bool valuate(Wff *wff, GHashTable *map, char **error);
+bool valuate(Wff *wff, const Valuation *values, char **error);
 
 char *wff_to_string(Wff *wff);
 
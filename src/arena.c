@@ -0,0 +1,112 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/arena.h"
+
+// the size of a chunk, unless an object does not fit in it
+#define CHUNK_SIZE (64 * 1024)
+
+#define ALIGNMENT alignof(max_align_t)
+
+struct ArenaChunk {
+    ArenaChunk *next;
+    size_t size;
+    size_t top;
+    alignas(max_align_t) unsigned char data[];
+};
+
+static _Thread_local Arena *current = NULL;
+
+Arena *create_arena() {
+    Arena *arena = malloc(sizeof(Arena));
+    arena->chunks = NULL;
+    arena->used = 0;
+    arena->reserved = 0;
+    return arena;
+}
+
+void free_arena(Arena *arena) {
+    for (ArenaChunk *chunk = arena->chunks, *next; chunk != NULL; chunk = next) {
+        next = chunk->next;
+        free(chunk);
+    }
+    if (current == arena) {
+        current = NULL;
+    }
+    free(arena);
+}
+
+void merge_arena(Arena *into, Arena *from) {
+    // the chunks of from follow the current chunk of into, which keeps bumping its own
+    ArenaChunk *last = from->chunks;
+    while (last != NULL && last->next != NULL) {
+        last = last->next;
+    }
+    if (last != NULL && into->chunks != NULL) {
+        last->next = into->chunks->next;
+        into->chunks->next = from->chunks;
+    } else if (last != NULL) {
+        into->chunks = from->chunks;
+    }
+    into->used += from->used;
+    into->reserved += from->reserved;
+    if (current == from) {
+        current = NULL;
+    }
+    free(from);
+}
+
+static void *bump(Arena *arena, size_t size, size_t alignment) {
+    ArenaChunk *chunk = arena->chunks;
+    size_t top = chunk != NULL ? (chunk->top + alignment - 1) & ~(alignment - 1) : 0;
+    if (chunk == NULL || top > chunk->size || chunk->size - top < size) {
+        size_t n = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+        chunk = malloc(sizeof(ArenaChunk) + n);
+        chunk->size = n;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->reserved += n;
+        top = 0;
+    }
+    chunk->top = top + size;
+    arena->used += size;
+    return chunk->data + top;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+    return bump(arena, size, ALIGNMENT);
+}
+
+// strings need no alignment
+char *arena_strdup(Arena *arena, const char *str) {
+    size_t n = strlen(str) + 1;
+    return memcpy(bump(arena, n, 1), str, n);
+}
+
+size_t arena_bytes_used(const Arena *arena) {
+    return arena->used;
+}
+
+size_t arena_bytes_reserved(const Arena *arena) {
+    return arena->reserved;
+}
+
+void set_arena(Arena *arena) {
+    current = arena;
+}
+
+Arena *get_arena() {
+    return current;
+}
+
+void *scoped_alloc(size_t size) {
+    return current != NULL ? arena_alloc(current, size) : malloc(size);
+}
+
+char *scoped_strdup(const char *str) {
+    return current != NULL ? arena_strdup(current, str) : strdup(str);
+}
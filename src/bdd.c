@@ -0,0 +1,358 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <limits.h>
+#include "../include/bdd.h"
+
+#define NODE(f) ((f) >> 1)
+#define IS_COMPLEMENT(f) ((f) & 1)
+#define EDGE(node, complement) (((node) << 1) | (complement))
+
+// the variable of the terminal is below every atom, and the one of a free node is -1
+#define TERMINAL_VAR INT_MAX
+#define FREE_VAR (-1)
+
+#define NO_NODE UINT32_MAX
+
+// the minimum number of live nodes which triggers a garbage collection
+#define GC_THRESHOLD (1u << 16)
+
+typedef struct {
+    int var;
+    Bdd low;
+    Bdd high;
+    // the next node in the bucket of the unique table, or in the free list
+    uint32_t next;
+    uint32_t ref;
+    bool mark;
+} Node;
+
+typedef struct {
+    Bdd f;
+    Bdd g;
+    Bdd h;
+    Bdd r;
+} CacheEntry;
+
+// every thread has its own nodes and tables, hence the threads which decide different statements
+// never share a BDD
+static _Thread_local Node *nodes = NULL;
+static _Thread_local uint32_t capacity = 0;
+static _Thread_local uint32_t used = 0;
+static _Thread_local uint32_t live = 0;
+static _Thread_local uint32_t free_list = NO_NODE;
+
+// the unique table, whose buckets are as many as the nodes' capacity
+static _Thread_local uint32_t *buckets = NULL;
+
+static _Thread_local CacheEntry *cache = NULL;
+
+static _Thread_local uint32_t gc_threshold = GC_THRESHOLD;
+static _Thread_local bool limit_reached = false;
+
+static inline uint32_t hash3(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t h = a * 0x9E3779B1u;
+    h ^= b + 0x85EBCA77u + (h << 6) + (h >> 2);
+    h ^= c + 0xC2B2AE3Du + (h << 6) + (h >> 2);
+    return h;
+}
+
+static void clear_cache() {
+    for (uint32_t i = 0; i < capacity; i++) {
+        cache[i].f = NO_NODE;
+    }
+}
+
+static void rehash() {
+    for (uint32_t i = 0; i < capacity; i++) {
+        buckets[i] = NO_NODE;
+    }
+    for (uint32_t i = 1; i < used; i++) {
+        if (nodes[i].var != FREE_VAR) {
+            uint32_t b = hash3(nodes[i].var, nodes[i].low, nodes[i].high) & (capacity - 1);
+            nodes[i].next = buckets[b];
+            buckets[b] = i;
+        }
+    }
+}
+
+static void grow(uint32_t c) {
+    nodes = realloc(nodes, c * sizeof(Node));
+    buckets = realloc(buckets, c * sizeof(uint32_t));
+    cache = realloc(cache, c * sizeof(CacheEntry));
+    capacity = c;
+    rehash();
+    clear_cache();
+}
+
+static void init() {
+    if (nodes != NULL) return;
+    grow(1u << 12);
+    nodes[0].var = TERMINAL_VAR;
+    nodes[0].low = BDD_TRUE;
+    nodes[0].high = BDD_TRUE;
+    nodes[0].ref = 1;
+    nodes[0].mark = false;
+    used = 1;
+    live = 1;
+}
+
+// returns the node (var, low, high), which must be reduced and have a regular high edge
+static Bdd unique(int var, Bdd low, Bdd high) {
+    uint32_t b = hash3(var, low, high) & (capacity - 1);
+    for (uint32_t i = buckets[b]; i != NO_NODE; i = nodes[i].next) {
+        if (nodes[i].var == var && nodes[i].low == low && nodes[i].high == high) {
+            return EDGE(i, 0);
+        }
+    }
+
+    uint32_t i;
+    if (free_list != NO_NODE) {
+        i = free_list;
+        free_list = nodes[i].next;
+    } else {
+        if (used == capacity) {
+            if (capacity >= MAX_BDD_NODES) {
+                limit_reached = true;
+                return BDD_FALSE;
+            }
+            grow(2 * capacity);
+            b = hash3(var, low, high) & (capacity - 1);
+        }
+        i = used++;
+    }
+    nodes[i].var = var;
+    nodes[i].low = low;
+    nodes[i].high = high;
+    nodes[i].ref = 0;
+    nodes[i].mark = false;
+    nodes[i].next = buckets[b];
+    buckets[b] = i;
+    live++;
+    return EDGE(i, 0);
+}
+
+static Bdd make(int var, Bdd low, Bdd high) {
+    if (low == high) {
+        return low;
+    }
+    // the complement is moved from the high edge to the edge which points to the node
+    if (IS_COMPLEMENT(high)) {
+        return bdd_not(unique(var, bdd_not(low), bdd_not(high)));
+    }
+    return unique(var, low, high);
+}
+
+static inline int var_of(Bdd f) {
+    return nodes[NODE(f)].var;
+}
+
+static inline Bdd low_of(Bdd f, int var) {
+    return var_of(f) == var ? nodes[NODE(f)].low ^ IS_COMPLEMENT(f) : f;
+}
+
+static inline Bdd high_of(Bdd f, int var) {
+    return var_of(f) == var ? nodes[NODE(f)].high ^ IS_COMPLEMENT(f) : f;
+}
+
+Bdd bdd_var(int atom) {
+    init();
+    return make(atom, BDD_FALSE, BDD_TRUE);
+}
+
+static Bdd ite(Bdd f, Bdd g, Bdd h) {
+    if (limit_reached) return BDD_FALSE;
+
+    if (f == BDD_TRUE) return g;
+    if (f == BDD_FALSE) return h;
+    if (g == f) g = BDD_TRUE;
+    else if (g == bdd_not(f)) g = BDD_FALSE;
+    if (h == f) h = BDD_FALSE;
+    else if (h == bdd_not(f)) h = BDD_TRUE;
+    if (g == h) return g;
+    if (g == BDD_TRUE && h == BDD_FALSE) return f;
+    if (g == BDD_FALSE && h == BDD_TRUE) return bdd_not(f);
+
+    // the standard triple has a regular condition and a regular then branch
+    if (IS_COMPLEMENT(f)) {
+        f = bdd_not(f);
+        Bdd t = g;
+        g = h;
+        h = t;
+    }
+    Bdd complement = 0;
+    if (IS_COMPLEMENT(g)) {
+        g = bdd_not(g);
+        h = bdd_not(h);
+        complement = 1;
+    }
+
+    CacheEntry *entry = &cache[hash3(f, g, h) & (capacity - 1)];
+    if (entry->f == f && entry->g == g && entry->h == h) {
+        return entry->r ^ complement;
+    }
+
+    int var = var_of(f);
+    if (var_of(g) < var) var = var_of(g);
+    if (var_of(h) < var) var = var_of(h);
+
+    Bdd low = ite(low_of(f, var), low_of(g, var), low_of(h, var));
+    Bdd high = ite(high_of(f, var), high_of(g, var), high_of(h, var));
+    Bdd r = make(var, low, high);
+    if (limit_reached) return BDD_FALSE;
+
+    // the tables may have grown in the meantime
+    entry = &cache[hash3(f, g, h) & (capacity - 1)];
+    entry->f = f;
+    entry->g = g;
+    entry->h = h;
+    entry->r = r;
+    return r ^ complement;
+}
+
+Bdd bdd_ite(Bdd f, Bdd g, Bdd h) {
+    init();
+    return ite(f, g, h);
+}
+
+Bdd bdd_and(Bdd f, Bdd g) {
+    return bdd_ite(f, g, BDD_FALSE);
+}
+
+Bdd bdd_or(Bdd f, Bdd g) {
+    return bdd_ite(f, BDD_TRUE, g);
+}
+
+Bdd bdd_implies(Bdd f, Bdd g) {
+    return bdd_ite(f, g, BDD_TRUE);
+}
+
+// the intermediate results are kept alive by the memo until the wff is compiled
+static Bdd compile(Wff *wff, GHashTable *memo) {
+    gpointer known;
+    if (g_hash_table_lookup_extended(memo, wff, NULL, &known)) {
+        return GPOINTER_TO_UINT(known);
+    }
+
+    Bdd f;
+    switch (wff->type) {
+        case WFF_ATOMIC_CONDITION:
+            f = make(wff->atom, BDD_FALSE, BDD_TRUE);
+            break;
+        case WFF_NEGATION:
+            f = bdd_not(compile(wff->wff1, memo));
+            break;
+        case WFF_CONJUNCTION:
+            f = ite(compile(wff->wff1, memo), compile(wff->wff2, memo), BDD_FALSE);
+            break;
+        case WFF_DISJUNCTION:
+            f = ite(compile(wff->wff1, memo), BDD_TRUE, compile(wff->wff2, memo));
+            break;
+        case WFF_CONDITIONAL:
+            f = ite(compile(wff->wff1, memo), compile(wff->wff2, memo), BDD_TRUE);
+            break;
+        default:
+            // arguments and conditions are never compiled
+            f = BDD_FALSE;
+            break;
+    }
+    g_hash_table_insert(memo, wff, GUINT_TO_POINTER(f));
+    return f;
+}
+
+Bdd bdd_from_wff(Wff *wff) {
+    init();
+    if (live >= gc_threshold) {
+        bdd_gc();
+    }
+
+    // no collection happens during the compilation, hence the nodes in the memo stay alive
+    GHashTable *memo = g_hash_table_new(g_direct_hash, g_direct_equal);
+    Bdd f = compile(wff, memo);
+    g_hash_table_destroy(memo);
+    bdd_ref(f);
+    return f;
+}
+
+void bdd_ref(Bdd f) {
+    init();
+    nodes[NODE(f)].ref++;
+}
+
+void bdd_deref(Bdd f) {
+    nodes[NODE(f)].ref--;
+}
+
+static void mark(uint32_t root, GArray *stack) {
+    g_array_append_val(stack, root);
+    while (stack->len > 0) {
+        uint32_t i = g_array_index(stack, uint32_t, stack->len - 1);
+        g_array_set_size(stack, stack->len - 1);
+        if (nodes[i].mark) continue;
+        nodes[i].mark = true;
+        if (i != 0) {
+            uint32_t low = NODE(nodes[i].low);
+            uint32_t high = NODE(nodes[i].high);
+            g_array_append_val(stack, low);
+            g_array_append_val(stack, high);
+        }
+    }
+}
+
+void bdd_gc() {
+    if (nodes == NULL) return;
+
+    GArray *stack = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+    for (uint32_t i = 0; i < used; i++) {
+        if (nodes[i].var != FREE_VAR && nodes[i].ref > 0) {
+            mark(i, stack);
+        }
+    }
+    g_array_free(stack, TRUE);
+
+    live = 0;
+    for (uint32_t i = 0; i < used; i++) {
+        if (nodes[i].var == FREE_VAR) continue;
+        if (nodes[i].mark) {
+            nodes[i].mark = false;
+            live++;
+        } else {
+            nodes[i].var = FREE_VAR;
+            nodes[i].next = free_list;
+            free_list = i;
+        }
+    }
+    rehash();
+    clear_cache();
+
+    // the next collection waits for the live nodes to double
+    gc_threshold = live > GC_THRESHOLD / 2 ? 2 * live : GC_THRESHOLD;
+}
+
+size_t bdd_node_count() {
+    return live;
+}
+
+bool bdd_limit_reached() {
+    return limit_reached;
+}
+
+void bdd_reset_limit() {
+    limit_reached = false;
+}
+
+void bdd_clear() {
+    free(nodes);
+    free(buckets);
+    free(cache);
+    nodes = NULL;
+    buckets = NULL;
+    cache = NULL;
+    capacity = 0;
+    used = 0;
+    live = 0;
+    free_list = NO_NODE;
+    gc_threshold = GC_THRESHOLD;
+    limit_reached = false;
+}
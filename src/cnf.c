@@ -0,0 +1,113 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include "../include/cnf.h"
+
+Cnf *create_cnf() {
+    Cnf *cnf = malloc(sizeof(Cnf));
+    cnf->n_vars = 0;
+    cnf->n_clauses = 0;
+    cnf->literals = g_array_new(FALSE, FALSE, sizeof(int));
+    cnf->atoms = g_array_new(FALSE, TRUE, sizeof(int));
+    cnf->names = g_ptr_array_new();
+    // the variable 0 does not exist
+    g_ptr_array_add(cnf->names, NULL);
+    cnf->nodes = g_hash_table_new(g_direct_hash, g_direct_equal);
+    cnf->ids = g_hash_table_new(g_direct_hash, g_direct_equal);
+    return cnf;
+}
+
+void free_cnf(Cnf *cnf) {
+    g_array_free(cnf->literals, TRUE);
+    g_array_free(cnf->atoms, TRUE);
+    g_ptr_array_free(cnf->names, TRUE);
+    g_hash_table_destroy(cnf->nodes);
+    g_hash_table_destroy(cnf->ids);
+    free(cnf);
+}
+
+static int new_var(Cnf *cnf, const char *name) {
+    g_ptr_array_add(cnf->names, (gpointer) name);
+    return ++cnf->n_vars;
+}
+
+void add_clause(Cnf *cnf, const int *literals, size_t n) {
+    static const int end = 0;
+    g_array_append_vals(cnf->literals, literals, n);
+    g_array_append_val(cnf->literals, end);
+    cnf->n_clauses++;
+}
+
+static void add_clause2(Cnf *cnf, int a, int b) {
+    int c[] = {a, b};
+    add_clause(cnf, c, 2);
+}
+
+static void add_clause3(Cnf *cnf, int a, int b, int c) {
+    int d[] = {a, b, c};
+    add_clause(cnf, d, 3);
+}
+
+int encode_wff(Cnf *cnf, Wff *wff) {
+    if (wff->type == WFF_NEGATION) {
+        return -encode_wff(cnf, wff->wff1);
+    }
+
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        if (cnf->atoms->len <= (guint) wff->atom) {
+            g_array_set_size(cnf->atoms, wff->atom + 1);
+        }
+        int *var = &g_array_index(cnf->atoms, int, wff->atom);
+        if (*var == 0) {
+            *var = new_var(cnf, atom_name(wff->atom));
+        }
+        return *var;
+    }
+
+    // a subformula shared by several wff, or equal to another one up to the order of the operands
+    // of & and |, is encoded only once
+    GHashTable *memo = wff->id >= 0 ? cnf->ids : cnf->nodes;
+    gpointer key = wff->id >= 0 ? GINT_TO_POINTER(wff->id) : wff;
+    gpointer known = g_hash_table_lookup(memo, key);
+    if (known != NULL) {
+        return GPOINTER_TO_INT(known);
+    }
+
+    int a = encode_wff(cnf, wff->wff1);
+    int b = encode_wff(cnf, wff->wff2);
+    int x = new_var(cnf, NULL);
+    if (wff->type == WFF_CONJUNCTION) {
+        // x <-> (a & b)
+        add_clause2(cnf, -x, a);
+        add_clause2(cnf, -x, b);
+        add_clause3(cnf, x, -a, -b);
+    } else if (wff->type == WFF_DISJUNCTION) {
+        // x <-> (a | b)
+        add_clause2(cnf, x, -a);
+        add_clause2(cnf, x, -b);
+        add_clause3(cnf, -x, a, b);
+    } else {
+        // x <-> (a -> b)
+        add_clause2(cnf, x, a);
+        add_clause2(cnf, x, -b);
+        add_clause3(cnf, -x, -a, b);
+    }
+    g_hash_table_insert(memo, key, GINT_TO_POINTER(x));
+    return x;
+}
+
+bool load_cnf(Solver *solver, const Cnf *cnf) {
+    while (solver_n_vars(solver) < cnf->n_vars) {
+        solver_new_var(solver);
+    }
+    bool ok = true;
+    const int *clause = (const int *) cnf->literals->data;
+    for (size_t i = 0; i < cnf->n_clauses; i++) {
+        size_t n = 0;
+        while (clause[n] != 0) n++;
+        ok = solver_add_clause(solver, clause, n) && ok;
+        clause += n + 1;
+    }
+    return ok;
+}
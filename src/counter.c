@@ -0,0 +1,406 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/cnf.h"
+#include "../include/counter.h"
+
+// a count is an unsigned integer of any size, as 32-bit limbs from the least significant one;
+// zero has no limbs
+typedef GArray Count;
+
+static Count *create_count() {
+    return g_array_new(FALSE, TRUE, sizeof(guint32));
+}
+
+static Count *copy_count(const Count *a) {
+    Count *b = create_count();
+    g_array_append_vals(b, a->data, a->len);
+    return b;
+}
+
+static void free_count(gpointer a) {
+    g_array_free((Count *) a, TRUE);
+}
+
+static Count *power_of_two(int k) {
+    Count *a = create_count();
+    g_array_set_size(a, k / 32 + 1);
+    g_array_index(a, guint32, k / 32) = 1u << (k % 32);
+    return a;
+}
+
+static void trim(Count *a) {
+    while (a->len > 0 && g_array_index(a, guint32, a->len - 1) == 0) {
+        g_array_set_size(a, a->len - 1);
+    }
+}
+
+// a += b
+static void add_count(Count *a, const Count *b) {
+    if (a->len < b->len) {
+        g_array_set_size(a, b->len);
+    }
+    guint64 carry = 0;
+    for (guint i = 0; i < a->len; i++) {
+        guint64 sum = carry + g_array_index(a, guint32, i) + (i < b->len ? g_array_index(b, guint32, i) : 0);
+        g_array_index(a, guint32, i) = (guint32) sum;
+        carry = sum >> 32;
+    }
+    if (carry > 0) {
+        guint32 limb = (guint32) carry;
+        g_array_append_val(a, limb);
+    }
+}
+
+static Count *multiply_counts(const Count *a, const Count *b) {
+    Count *c = create_count();
+    if (a->len == 0 || b->len == 0) {
+        return c;
+    }
+    g_array_set_size(c, a->len + b->len);
+    for (guint i = 0; i < a->len; i++) {
+        guint64 carry = 0;
+        for (guint j = 0; j < b->len; j++) {
+            guint64 t = (guint64) g_array_index(a, guint32, i) * g_array_index(b, guint32, j) +
+                        g_array_index(c, guint32, i + j) + carry;
+            g_array_index(c, guint32, i + j) = (guint32) t;
+            carry = t >> 32;
+        }
+        g_array_index(c, guint32, i + b->len) = (guint32) carry;
+    }
+    trim(c);
+    return c;
+}
+
+static char *count_to_string(const Count *a) {
+    // the digits are taken nine at a time, from the least significant ones
+    Count *q = copy_count(a);
+    GArray *chunks = g_array_new(FALSE, FALSE, sizeof(guint32));
+    do {
+        guint64 r = 0;
+        for (guint i = q->len; i-- > 0;) {
+            guint64 t = (r << 32) | g_array_index(q, guint32, i);
+            g_array_index(q, guint32, i) = (guint32) (t / 1000000000u);
+            r = t % 1000000000u;
+        }
+        guint32 chunk = (guint32) r;
+        g_array_append_val(chunks, chunk);
+        trim(q);
+    } while (q->len > 0);
+
+    GString *s = g_string_new(NULL);
+    g_string_append_printf(s, "%u", g_array_index(chunks, guint32, chunks->len - 1));
+    for (guint i = chunks->len - 1; i-- > 0;) {
+        g_string_append_printf(s, "%09u", g_array_index(chunks, guint32, i));
+    }
+    g_array_free(chunks, TRUE);
+    free_count(q);
+    return g_string_free(s, FALSE);
+}
+
+typedef struct {
+    int n;
+    int literals[];
+} Clause;
+
+static Clause *create_clause(const int *literals, int n) {
+    Clause *c = g_malloc(sizeof(Clause) + n * sizeof(int));
+    c->n = n;
+    memcpy(c->literals, literals, n * sizeof(int));
+    return c;
+}
+
+typedef struct {
+    // the values of the variables during a propagation: 1 true, -1 false, and 0 none
+    signed char *values;
+    GArray *trail;
+    // the marks of the variables which a step has met, and the stamp of the step
+    unsigned *seen;
+    unsigned stamp;
+    int *parent;
+    int *occurrences;
+    // the count of every component, by its clauses
+    GHashTable *cache;
+} Counter;
+
+static Count *count_clauses(Counter *c, GPtrArray *clauses, int n_vars);
+
+static int compare_literals(const void *a, const void *b) {
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return x < y ? -1 : x > y;
+}
+
+static gint compare_clauses(gconstpointer a, gconstpointer b) {
+    const Clause *x = *(const Clause **) a;
+    const Clause *y = *(const Clause **) b;
+    for (int i = 0; i < x->n && i < y->n; i++) {
+        if (x->literals[i] != y->literals[i]) {
+            return x->literals[i] < y->literals[i] ? -1 : 1;
+        }
+    }
+    return x->n - y->n;
+}
+
+static int find(Counter *c, int v) {
+    while (c->parent[v] != v) {
+        c->parent[v] = c->parent[c->parent[v]];
+        v = c->parent[v];
+    }
+    return v;
+}
+
+// the literals of every clause are sorted, hence sorting the clauses gives a canonical form
+static char *component_key(GPtrArray *component) {
+    g_ptr_array_sort(component, compare_clauses);
+    GString *key = g_string_new(NULL);
+    for (guint i = 0; i < component->len; i++) {
+        const Clause *clause = g_ptr_array_index(component, i);
+        for (int j = 0; j < clause->n; j++) {
+            g_string_append_printf(key, "%d ", clause->literals[j]);
+        }
+        g_string_append_c(key, '0');
+    }
+    return g_string_free(key, FALSE);
+}
+
+static Count *count_component(Counter *c, GPtrArray *component) {
+    char *key = component_key(component);
+    Count *known = g_hash_table_lookup(c->cache, key);
+    if (known != NULL) {
+        g_free(key);
+        return copy_count(known);
+    }
+
+    // the component is split on its most frequent variable
+    GArray *vars = g_array_new(FALSE, FALSE, sizeof(int));
+    for (guint i = 0; i < component->len; i++) {
+        const Clause *clause = g_ptr_array_index(component, i);
+        for (int j = 0; j < clause->n; j++) {
+            int v = abs(clause->literals[j]);
+            if (c->occurrences[v]++ == 0) {
+                g_array_append_val(vars, v);
+            }
+        }
+    }
+    int best = g_array_index(vars, int, 0);
+    for (guint i = 0; i < vars->len; i++) {
+        int v = g_array_index(vars, int, i);
+        if (c->occurrences[v] > c->occurrences[best]) {
+            best = v;
+        }
+    }
+    for (guint i = 0; i < vars->len; i++) {
+        c->occurrences[g_array_index(vars, int, i)] = 0;
+    }
+
+    Count *count = create_count();
+    for (int sign = 1; sign >= -1; sign -= 2) {
+        int literal = sign * best;
+        Clause *unit = create_clause(&literal, 1);
+        GPtrArray *branch = g_ptr_array_sized_new(component->len + 1);
+        g_ptr_array_add(branch, unit);
+        for (guint i = 0; i < component->len; i++) {
+            g_ptr_array_add(branch, g_ptr_array_index(component, i));
+        }
+        Count *side = count_clauses(c, branch, (int) vars->len);
+        add_count(count, side);
+        free_count(side);
+        g_ptr_array_free(branch, TRUE);
+        g_free(unit);
+    }
+    g_array_free(vars, TRUE);
+
+    g_hash_table_insert(c->cache, key, copy_count(count));
+    return count;
+}
+
+// counts the assignments of n_vars variables, which include those of the clauses, that satisfy
+// the clauses
+static Count *count_clauses(Counter *c, GPtrArray *clauses, int n_vars) {
+    guint start = c->trail->len;
+    bool conflict = false;
+    for (bool changed = true; changed && !conflict;) {
+        changed = false;
+        for (guint i = 0; i < clauses->len && !conflict; i++) {
+            const Clause *clause = g_ptr_array_index(clauses, i);
+            int unassigned = 0;
+            int last = 0;
+            bool satisfied = false;
+            for (int j = 0; j < clause->n && !satisfied; j++) {
+                int literal = clause->literals[j];
+                int value = c->values[abs(literal)];
+                if (value == 0) {
+                    unassigned++;
+                    last = literal;
+                } else {
+                    satisfied = (value > 0) == (literal > 0);
+                }
+            }
+            if (satisfied || unassigned > 1) {
+                continue;
+            }
+            if (unassigned == 0) {
+                conflict = true;
+            } else {
+                c->values[abs(last)] = last > 0 ? 1 : -1;
+                g_array_append_val(c->trail, last);
+                changed = true;
+            }
+        }
+    }
+
+    // the clauses which are left, without their false literals
+    GPtrArray *left = g_ptr_array_new_with_free_func(g_free);
+    int n_left = 0;
+    c->stamp++;
+    for (guint i = 0; i < clauses->len && !conflict; i++) {
+        const Clause *clause = g_ptr_array_index(clauses, i);
+        int literals[clause->n];
+        int n = 0;
+        bool satisfied = false;
+        for (int j = 0; j < clause->n && !satisfied; j++) {
+            int literal = clause->literals[j];
+            int value = c->values[abs(literal)];
+            if (value == 0) {
+                literals[n++] = literal;
+            } else {
+                satisfied = (value > 0) == (literal > 0);
+            }
+        }
+        if (satisfied) {
+            continue;
+        }
+        qsort(literals, n, sizeof(int), compare_literals);
+        g_ptr_array_add(left, create_clause(literals, n));
+        for (int j = 0; j < n; j++) {
+            int v = abs(literals[j]);
+            if (c->seen[v] != c->stamp) {
+                c->seen[v] = c->stamp;
+                c->parent[v] = v;
+                n_left++;
+            }
+        }
+    }
+    int n_assigned = (int) (c->trail->len - start);
+    for (guint i = start; i < c->trail->len; i++) {
+        c->values[abs(g_array_index(c->trail, int, i))] = 0;
+    }
+    g_array_set_size(c->trail, start);
+    if (conflict) {
+        g_ptr_array_free(left, TRUE);
+        return create_count();
+    }
+
+    // the variables which no clause mentions any more take any value
+    Count *count = power_of_two(n_vars - n_assigned - n_left);
+
+    // the clauses which share a variable are in the same component
+    for (guint i = 0; i < left->len; i++) {
+        const Clause *clause = g_ptr_array_index(left, i);
+        int root = find(c, abs(clause->literals[0]));
+        for (int j = 1; j < clause->n; j++) {
+            int other = find(c, abs(clause->literals[j]));
+            if (other != root) {
+                c->parent[other] = root;
+            }
+        }
+    }
+    GHashTable *components = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                   (GDestroyNotify) g_ptr_array_unref);
+    for (guint i = 0; i < left->len; i++) {
+        Clause *clause = g_ptr_array_index(left, i);
+        gpointer root = GINT_TO_POINTER(find(c, abs(clause->literals[0])));
+        GPtrArray *component = g_hash_table_lookup(components, root);
+        if (component == NULL) {
+            component = g_ptr_array_new();
+            g_hash_table_insert(components, root, component);
+        }
+        g_ptr_array_add(component, clause);
+    }
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, components);
+    while (count->len > 0 && g_hash_table_iter_next(&iter, NULL, &value)) {
+        Count *factor = count_component(c, (GPtrArray *) value);
+        Count *product = multiply_counts(count, factor);
+        free_count(factor);
+        free_count(count);
+        count = product;
+    }
+    g_hash_table_destroy(components);
+    g_ptr_array_free(left, TRUE);
+    return count;
+}
+
+// adds the clauses of the encoding, and the unit clauses of the roots
+static GPtrArray *clauses_of(const Cnf *cnf, const int *roots, int n_roots) {
+    GPtrArray *clauses = g_ptr_array_new_with_free_func(g_free);
+    const int *literals = (const int *) cnf->literals->data;
+    for (size_t i = 0; i < cnf->n_clauses; i++) {
+        int n = 0;
+        while (literals[n] != 0) n++;
+        g_ptr_array_add(clauses, create_clause(literals, n));
+        literals += n + 1;
+    }
+    for (int i = 0; i < n_roots; i++) {
+        g_ptr_array_add(clauses, create_clause(&roots[i], 1));
+    }
+    return clauses;
+}
+
+void count_argument(Wff *argument, char **models, char **counterexamples, int *n_atoms) {
+    // the conclusion is encoded in both counts, hence they are over the same atoms
+    Cnf *cnf = create_cnf();
+    GArray *roots = g_array_new(FALSE, FALSE, sizeof(int));
+    for (GSList *list = argument->premises; list != NULL; list = list->next) {
+        int root = encode_wff(cnf, (Wff *) list->data);
+        g_array_append_val(roots, root);
+    }
+    int conclusion = argument->wff1 != NULL ? encode_wff(cnf, argument->wff1) : 0;
+
+    *n_atoms = 0;
+    for (int v = 1; v <= cnf->n_vars; v++) {
+        *n_atoms += g_ptr_array_index(cnf->names, v) != NULL;
+    }
+
+    Counter c;
+    c.values = g_new0(signed char, cnf->n_vars + 1);
+    c.trail = g_array_new(FALSE, FALSE, sizeof(int));
+    c.seen = g_new0(unsigned, cnf->n_vars + 1);
+    c.stamp = 0;
+    c.parent = g_new(int, cnf->n_vars + 1);
+    c.occurrences = g_new0(int, cnf->n_vars + 1);
+    c.cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free_count);
+
+    GPtrArray *clauses = clauses_of(cnf, (int *) roots->data, (int) roots->len);
+    Count *count = count_clauses(&c, clauses, cnf->n_vars);
+    *models = count_to_string(count);
+    free_count(count);
+    g_ptr_array_free(clauses, TRUE);
+
+    *counterexamples = NULL;
+    if (conclusion != 0) {
+        int negation = -conclusion;
+        g_array_append_val(roots, negation);
+        clauses = clauses_of(cnf, (int *) roots->data, (int) roots->len);
+        count = count_clauses(&c, clauses, cnf->n_vars);
+        *counterexamples = count_to_string(count);
+        free_count(count);
+        g_ptr_array_free(clauses, TRUE);
+    }
+
+    g_hash_table_destroy(c.cache);
+    g_free(c.values);
+    g_array_free(c.trail, TRUE);
+    g_free(c.seen);
+    g_free(c.parent);
+    g_free(c.occurrences);
+    g_array_free(roots, TRUE);
+    free_cnf(cnf);
+}
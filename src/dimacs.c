@@ -0,0 +1,190 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <errno.h>
+#include <glib.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/cnf.h"
+#include "../include/dimacs.h"
+#include "../include/unique.h"
+
+void write_dimacs(FILE *file, Wff *argument) {
+    Cnf *cnf = create_cnf();
+    GArray *roots = g_array_new(FALSE, FALSE, sizeof(int));
+    if (argument->wff1 != NULL) {
+        for (GSList *list = argument->premises; list != NULL; list = list->next) {
+            int root = encode_wff(cnf, (Wff *) list->data);
+            g_array_append_val(roots, root);
+        }
+        int root = -encode_wff(cnf, argument->wff1);
+        g_array_append_val(roots, root);
+    } else {
+        int root = -encode_wff(cnf, (Wff *) argument->premises->data);
+        g_array_append_val(roots, root);
+    }
+    for (guint i = 0; i < roots->len; i++) {
+        add_clause(cnf, &g_array_index(roots, int, i), 1);
+    }
+
+    fprintf(file, "c argument \"%s\"\n", argument->wff1 != NULL ? wff_to_string(argument)
+                                                                 : wff_to_string((Wff *) argument->premises->data));
+    for (int v = 1; v <= cnf->n_vars; v++) {
+        const char *name = g_ptr_array_index(cnf->names, v);
+        if (name != NULL) {
+            fprintf(file, "c atom %d %s\n", v, name);
+        }
+    }
+    fprintf(file, "p cnf %d %zu\n", cnf->n_vars, cnf->n_clauses);
+    const int *literal = (const int *) cnf->literals->data;
+    for (size_t i = 0; i < cnf->n_clauses; literal++) {
+        if (*literal == 0) {
+            fputs("0\n", file);
+            i++;
+        } else {
+            fprintf(file, "%d ", *literal);
+        }
+    }
+
+    g_array_free(roots, TRUE);
+    free_cnf(cnf);
+}
+
+// the atom of a variable, from its comment or else from its number
+static int atom_of(GHashTable *atoms, int var) {
+    gpointer atom = g_hash_table_lookup(atoms, GINT_TO_POINTER(var));
+    if (atom == NULL) {
+        char name[16];
+        snprintf(name, sizeof(name), "X%d", var);
+        atom = GINT_TO_POINTER(intern_atom(name) + 1);
+        g_hash_table_insert(atoms, GINT_TO_POINTER(var), atom);
+    }
+    return GPOINTER_TO_INT(atom) - 1;
+}
+
+// P & !P, for the atom of the first variable
+static Wff *contradiction(GHashTable *atoms) {
+    Wff *atom = unique_atomic_condition(atom_of(atoms, 1));
+    return unique_binary(WFF_CONJUNCTION, atom, unique_negation(atom));
+}
+
+// reads the clauses into the premises of an argument, whose conclusion is a contradiction if
+// refutation is true, or else is missing
+static Wff *read_clauses(FILE *file, bool refutation, char **error) {
+    Wff *argument = create_argument();
+    // the atom of every variable plus 1, by variable, since the comments may precede the header
+    GHashTable *atoms = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GArray *clause = g_array_new(FALSE, FALSE, sizeof(int));
+    GSList *premises = NULL;
+    bool header = false;
+    // the numbers of variables and clauses of the header, and the clauses read so far
+    long n_vars = 0;
+    long n_clauses = 0;
+    long read = 0;
+
+    // the lines are read whole, whatever their length
+    char *line = NULL;
+    size_t capacity = 0;
+    while (*error == NULL && getline(&line, &capacity, file) != -1) {
+        if (line[0] == 'c') {
+            long var;
+            char name[256];
+            if (sscanf(line, "c atom %ld %255s", &var, name) == 2 && var > 0 && var <= INT_MAX) {
+                g_hash_table_insert(atoms, GINT_TO_POINTER((int) var), GINT_TO_POINTER(intern_atom(name) + 1));
+            }
+            continue;
+        }
+        if (line[0] == 'p') {
+            char rest;
+            if (header) {
+                asprintf(error, "The DIMACS file has more than one 'p cnf' line");
+            } else if (sscanf(line, "p cnf %ld %ld %c", &n_vars, &n_clauses, &rest) != 2 ||
+                       n_vars < 0 || n_vars > INT_MAX || n_clauses < 0) {
+                asprintf(error, "Malformed header '%.*s' in the DIMACS file", (int) strcspn(line, "\r\n"), line);
+            }
+            header = true;
+            continue;
+        }
+        if (line[0] == '%') {
+            // the end of some benchmark files
+            break;
+        }
+
+        for (char *p = line, *end; *error == NULL; p = end) {
+            errno = 0;
+            long literal = strtol(p, &end, 10);
+            if (end == p) {
+                while (*end == ' ' || *end == '\t' || *end == '\r' || *end == '\n') end++;
+                if (*end != '\0') {
+                    asprintf(error, "Unexpected symbol '%c' in the DIMACS file", *end);
+                }
+                break;
+            }
+            if (!header) {
+                asprintf(error, "The clauses of the DIMACS file precede its 'p cnf' line");
+                break;
+            }
+            if (errno == ERANGE || literal < -n_vars || literal > n_vars) {
+                p += strspn(p, " \t");
+                asprintf(error, "The literal %.*s is not one of the %ld variables of the DIMACS file",
+                         (int) (end - p), p, n_vars);
+                break;
+            }
+            if (literal != 0) {
+                int l = (int) literal;
+                g_array_append_val(clause, l);
+                continue;
+            }
+
+            // a clause is the disjunction of its literals, and the empty one is a contradiction
+            Wff *wff = NULL;
+            for (guint i = 0; i < clause->len; i++) {
+                int l = g_array_index(clause, int, i);
+                Wff *atom = unique_atomic_condition(atom_of(atoms, abs(l)));
+                Wff *w = l > 0 ? atom : unique_negation(atom);
+                wff = wff == NULL ? w : unique_binary(WFF_DISJUNCTION, wff, w);
+            }
+            if (wff == NULL) {
+                wff = contradiction(atoms);
+            }
+            premises = g_slist_prepend(premises, wff);
+            g_array_set_size(clause, 0);
+            read++;
+        }
+    }
+    free(line);
+
+    if (*error == NULL && (!header || clause->len > 0)) {
+        asprintf(error, header ? "The last clause of the DIMACS file is not terminated by 0"
+                               : "The DIMACS file has no 'p cnf' line");
+    } else if (*error == NULL && read != n_clauses) {
+        asprintf(error, "The DIMACS file has %ld clauses, but its 'p cnf' line declares %ld", read, n_clauses);
+    }
+    if (*error == NULL && refutation) {
+        argument->wff1 = contradiction(atoms);
+    }
+    g_array_free(clause, TRUE);
+    g_hash_table_destroy(atoms);
+    if (*error != NULL) {
+        g_slist_free(premises);
+        return NULL;
+    }
+    argument->premises = g_slist_reverse(premises);
+    return argument;
+}
+
+Wff *read_dimacs(FILE *file, char **error) {
+    return read_clauses(file, false, error);
+}
+
+Wff *load_dimacs(const char *path, char **error) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        asprintf(error, "Failed to open the DIMACS file '%s': %s", path, strerror(errno));
+        return NULL;
+    }
+    Wff *argument = read_clauses(file, true, error);
+    fclose(file);
+    return argument;
+}
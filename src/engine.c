@@ -0,0 +1,288 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <stdio.h>
+#include "../include/bdd.h"
+#include "../include/cnf.h"
+#include "../include/engine.h"
+#include "../include/program.h"
+#include "../include/sat.h"
+#include "../include/simplify.h"
+#include "../include/sweep.h"
+#include "../include/tableau.h"
+#include "../include/truth_table.h"
+
+static Engine engine = ENGINE_AUTO;
+static bool report = false;
+
+void set_engine(Engine e) {
+    engine = e;
+}
+
+Engine get_engine() {
+    return engine;
+}
+
+void set_simplification_report(bool r) {
+    report = r;
+}
+
+bool engine_from_string(const char *name, Engine *e) {
+    if (strcmp(name, "auto") == 0) {
+        *e = ENGINE_AUTO;
+    } else if (strcmp(name, "bdd") == 0) {
+        *e = ENGINE_BDD;
+    } else if (strcmp(name, "sat") == 0) {
+        *e = ENGINE_SAT;
+    } else if (strcmp(name, "table") == 0) {
+        *e = ENGINE_TRUTH_TABLE;
+    } else if (strcmp(name, "tableau") == 0) {
+        *e = ENGINE_TABLEAU;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// The solver of the session holds the Tseitin definitions of all the wffs which were checked
+// since the session began. Any assignment of the atoms satisfies the definitions, hence the
+// formulae are assumed, rather than added as clauses, and what the solver learns stays valid for
+// the following checks. Every thread has its own session
+static _Thread_local Solver *session = NULL;
+static _Thread_local Cnf *session_cnf = NULL;
+
+void end_solver_session() {
+    if (session != NULL) {
+        free_solver(session);
+        free_cnf(session_cnf);
+        session = NULL;
+        session_cnf = NULL;
+    }
+}
+
+// true if the wffs, but for their outer negations, were built by the unique table, and so were
+// their subformulae
+static bool shareable(GSList *formulae) {
+    for (GSList *list = formulae; list != NULL; list = list->next) {
+        Wff *wff = (Wff *) list->data;
+        while (wff->type == WFF_NEGATION && wff->id < 0) {
+            wff = wff->wff1;
+        }
+        if (wff->id < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool session_satisfiable(GSList *formulae) {
+    if (session == NULL) {
+        session = create_solver();
+        session_cnf = create_cnf();
+    }
+
+    GArray *assumptions = g_array_new(FALSE, FALSE, sizeof(int));
+    for (GSList *list = formulae; list != NULL; list = list->next) {
+        int root = encode_wff(session_cnf, (Wff *) list->data);
+        g_array_append_val(assumptions, root);
+    }
+    // only the clauses of the wffs which are new to the session are added to the solver
+    load_cnf(session, session_cnf);
+    g_array_set_size(session_cnf->literals, 0);
+    session_cnf->n_clauses = 0;
+
+    bool satisfiable = solver_solve_assuming(session, (int *) assumptions->data, assumptions->len);
+    g_array_free(assumptions, TRUE);
+    return satisfiable;
+}
+
+static bool sat_satisfiable(GSList *formulae) {
+    if (shareable(formulae)) {
+        return session_satisfiable(formulae);
+    }
+
+    Cnf *cnf = create_cnf();
+    for (GSList *list = formulae; list != NULL; list = list->next) {
+        int root = encode_wff(cnf, (Wff *) list->data);
+        add_clause(cnf, &root, 1);
+    }
+
+    Solver *solver = create_solver();
+    bool satisfiable = load_cnf(solver, cnf) && solver_solve(solver);
+    free_solver(solver);
+    free_cnf(cnf);
+    return satisfiable;
+}
+
+// the formulae are satisfiable if the BDD of their conjunction is not the false constant
+static bool bdd_satisfiable(GSList *formulae, char **error) {
+    bdd_reset_limit();
+    Bdd conjunction = BDD_TRUE;
+    bdd_ref(conjunction);
+    for (GSList *list = formulae; list != NULL && conjunction != BDD_FALSE; list = list->next) {
+        Bdd f = bdd_from_wff((Wff *) list->data);
+        Bdd g = bdd_and(conjunction, f);
+        bdd_ref(g);
+        bdd_deref(f);
+        bdd_deref(conjunction);
+        conjunction = g;
+    }
+    bdd_deref(conjunction);
+
+    if (bdd_limit_reached()) {
+        asprintf(error, "Too many nodes (more than %u) for the BDD", MAX_BDD_NODES);
+        return FALSE;
+    }
+    return conjunction != BDD_FALSE;
+}
+
+static bool decide(GSList *formulae, char **error) {
+    if (engine == ENGINE_SAT) {
+        return sat_satisfiable(formulae);
+    }
+    if (engine == ENGINE_BDD) {
+        return bdd_satisfiable(formulae, error);
+    }
+    if (engine == ENGINE_TABLEAU) {
+        return tableau_satisfiable(formulae, get_sweep_threads());
+    }
+
+    // the formulae over a few atoms are decided by their truth table
+    TruthTable *table = create_truth_table(formulae);
+    if (table != NULL) {
+        bool satisfiable = truth_table_satisfiable(table);
+        free_truth_table(table);
+        return satisfiable;
+    }
+
+    // the formulae are lowered to a single conjunction
+    Program *program = create_program();
+    for (GSList *list = formulae; list != NULL; list = list->next) {
+        emit_wff(program, (Wff *) list->data);
+        if (list != formulae) {
+            emit_operator(program, OP_AND);
+        }
+    }
+
+    size_t n = program->atoms->len;
+    bool satisfiable;
+    if (engine == ENGINE_AUTO && n > AUTO_SWEEP_ATOMS) {
+        satisfiable = sat_satisfiable(formulae);
+    } else if (n > MAX_SWEEP_ATOMS) {
+        asprintf(error, "Too many atoms (%zu) for the truth table", n);
+        satisfiable = FALSE;
+    } else {
+        satisfiable = sweep_program(program, NULL);
+    }
+    free_program(program);
+    return satisfiable;
+}
+
+static void collect_atoms(Wff *wff, GHashTable *visited, GArray *atoms) {
+    if (!g_hash_table_add(visited, wff)) {
+        return;
+    }
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        g_array_append_val(atoms, wff->atom);
+    } else {
+        collect_atoms(wff->wff1, visited, atoms);
+        if (wff->type != WFF_NEGATION) {
+            collect_atoms(wff->wff2, visited, atoms);
+        }
+    }
+}
+
+static int find_root(int *parents, int atom) {
+    while (parents[atom] != atom) {
+        parents[atom] = parents[parents[atom]];
+        atom = parents[atom];
+    }
+    return atom;
+}
+
+// The formulae which share no atoms, even through other formulae, are independent, hence they are
+// satisfiable if every component of the formulae which are connected by their atoms is
+static bool decide_components(GSList *formulae, char **error) {
+    if (formulae->next == NULL) {
+        return decide(formulae, error);
+    }
+
+    int n_atoms = count_atoms();
+    int *parents = malloc(n_atoms * sizeof(int));
+    for (int i = 0; i < n_atoms; i++) {
+        parents[i] = i;
+    }
+    GHashTable *visited = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GArray *atoms = g_array_new(FALSE, FALSE, sizeof(int));
+    GArray *firsts = g_array_new(FALSE, FALSE, sizeof(int));
+    for (GSList *list = formulae; list != NULL; list = list->next) {
+        g_array_set_size(atoms, 0);
+        g_hash_table_remove_all(visited);
+        collect_atoms((Wff *) list->data, visited, atoms);
+        int first = g_array_index(atoms, int, 0);
+        for (guint i = 1; i < atoms->len; i++) {
+            parents[find_root(parents, g_array_index(atoms, int, i))] = find_root(parents, first);
+        }
+        g_array_append_val(firsts, first);
+    }
+
+    // the components, in the order of their first formulae
+    GHashTable *components = g_hash_table_new(g_direct_hash, g_direct_equal);
+    GPtrArray *roots = g_ptr_array_new();
+    guint i = 0;
+    for (GSList *list = formulae; list != NULL; list = list->next, i++) {
+        gpointer root = GINT_TO_POINTER(find_root(parents, g_array_index(firsts, int, i)));
+        GSList *component = g_hash_table_lookup(components, root);
+        if (component == NULL) {
+            g_ptr_array_add(roots, root);
+        }
+        g_hash_table_insert(components, root, g_slist_prepend(component, list->data));
+    }
+
+    bool satisfiable = TRUE;
+    for (i = 0; i < roots->len; i++) {
+        GSList *component = g_slist_reverse(g_hash_table_lookup(components, g_ptr_array_index(roots, i)));
+        if (satisfiable && *error == NULL) {
+            satisfiable = decide(component, error);
+        }
+        g_slist_free(component);
+    }
+
+    g_hash_table_destroy(components);
+    g_ptr_array_free(roots, TRUE);
+    g_array_free(firsts, TRUE);
+    g_array_free(atoms, TRUE);
+    g_hash_table_destroy(visited);
+    free(parents);
+    return satisfiable;
+}
+
+bool is_satisfiable(GSList *formulae, char **error) {
+    // a formula which is simplified to false makes the formulae unsatisfiable, and one which is
+    // simplified to true is dropped
+    GSList *simplified = NULL;
+    bool satisfiable = TRUE;
+    for (GSList *list = formulae; list != NULL && satisfiable; list = list->next) {
+        Wff *wff = (Wff *) list->data;
+        bool value;
+        Wff *s = simplify_wff(wff, &value);
+        if (report && s != NULL) {
+            fprintf(stderr, "Simplified a formula from %zu to %zu nodes\n", wff_size(wff), wff_size(s));
+        } else if (report) {
+            fprintf(stderr, "Simplified a formula from %zu nodes to %s\n", wff_size(wff), value ? "true" : "false");
+        }
+        if (s != NULL) {
+            simplified = g_slist_prepend(simplified, s);
+        } else {
+            satisfiable = value;
+        }
+    }
+
+    if (satisfiable && simplified != NULL) {
+        simplified = g_slist_reverse(simplified);
+        satisfiable = decide_components(simplified, error);
+    }
+    g_slist_free(simplified);
+    return satisfiable;
+}
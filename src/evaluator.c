@@ -0,0 +1,241 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include "../include/evaluator.h"
+#include "../include/jit.h"
+#include "../include/program.h"
+#include "../include/truth_table.h"
+
+// the targets of the jumps which end the valuation
+#define EVAL_TRUE (-1)
+#define EVAL_FALSE (-2)
+
+typedef struct {
+    int atom;
+    int if_true;
+    int if_false;
+} Test;
+
+struct Evaluator {
+    Wff *wff;
+    Test *code;
+    size_t length;
+    int start;
+    // the atoms which are tested
+    uint64_t *atoms;
+    size_t words;
+    // the truth table of the wff, if it has a few atoms, or else its machine code, or NULL
+    TruthTable *table;
+    Jit *jit;
+};
+
+// the probability that a wff is true, the expected number of tests which valuate it, and their
+// maximum number
+typedef struct {
+    double p;
+    double cost;
+    size_t tests;
+    // true if the second operand is tested first
+    bool swap;
+} Estimate;
+
+typedef struct {
+    Evaluator *evaluator;
+    GHashTable *estimates;
+    size_t capacity;
+} Compiler;
+
+static Estimate estimate(Compiler *c, Wff *wff) {
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        Estimate e = {0.5, 1, 1, false};
+        return e;
+    }
+    Estimate *known = g_hash_table_lookup(c->estimates, wff);
+    if (known != NULL) {
+        return *known;
+    }
+
+    Estimate e;
+    Estimate a = estimate(c, wff->wff1);
+    if (wff->type == WFF_NEGATION) {
+        e = a;
+        e.p = 1 - a.p;
+    } else {
+        Estimate b = estimate(c, wff->wff2);
+        // the probabilities that the first operand decides the result, in either order; the
+        // negations do not change them, since a negated conjunction is a disjunction of negations
+        double pa, pb;
+        if (wff->type == WFF_CONJUNCTION) {
+            e.p = a.p * b.p;
+            pa = 1 - a.p;
+            pb = 1 - b.p;
+        } else if (wff->type == WFF_DISJUNCTION) {
+            e.p = 1 - (1 - a.p) * (1 - b.p);
+            pa = a.p;
+            pb = b.p;
+        } else {
+            e.p = 1 - a.p * (1 - b.p);
+            pa = 1 - a.p;
+            pb = b.p;
+        }
+        double first = a.cost + (1 - pa) * b.cost;
+        double second = b.cost + (1 - pb) * a.cost;
+        e.swap = second < first;
+        e.cost = e.swap ? second : first;
+        e.tests = a.tests + b.tests;
+    }
+    Estimate *value = g_new(Estimate, 1);
+    *value = e;
+    g_hash_table_insert(c->estimates, wff, value);
+    return e;
+}
+
+static void emit_test(Compiler *c, int atom, int if_true, int if_false) {
+    Evaluator *e = c->evaluator;
+    if (e->length == c->capacity) {
+        c->capacity = c->capacity == 0 ? 16 : 2 * c->capacity;
+        e->code = realloc(e->code, c->capacity * sizeof(Test));
+    }
+    Test t = {atom, if_true, if_false};
+    e->code[e->length++] = t;
+
+    size_t word = (size_t) atom >> 6;
+    if (word >= e->words) {
+        e->atoms = realloc(e->atoms, (word + 1) * sizeof(uint64_t));
+        memset(e->atoms + e->words, 0, (word + 1 - e->words) * sizeof(uint64_t));
+        e->words = word + 1;
+    }
+    e->atoms[word] |= 1ull << (atom & 63);
+}
+
+// emits the tests of a wff, or of its negation, which jump to if_true or to if_false; the tests
+// of the first operand of a binary wff jump to the ones of the second, which follow them
+static void emit(Compiler *c, Wff *wff, bool negated, int if_true, int if_false) {
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        emit_test(c, wff->atom, negated ? if_false : if_true, negated ? if_true : if_false);
+        return;
+    }
+    if (wff->type == WFF_NEGATION) {
+        emit(c, wff->wff1, !negated, if_true, if_false);
+        return;
+    }
+
+    // P -> Q is !P | Q, and a negated conjunction, or disjunction, is the dual of the negations
+    bool conjunction = (wff->type == WFF_CONJUNCTION) != negated;
+    bool x_negated = wff->type == WFF_CONDITIONAL ? !negated : negated;
+    Wff *x = wff->wff1;
+    Wff *y = wff->wff2;
+    bool y_negated = negated;
+    Estimate e = estimate(c, wff);
+    if (e.swap) {
+        Wff *w = x;
+        x = y;
+        y = w;
+        bool n = x_negated;
+        x_negated = y_negated;
+        y_negated = n;
+    }
+
+    int next = (int) (c->evaluator->length + estimate(c, x).tests);
+    if (conjunction) {
+        emit(c, x, x_negated, next, if_false);
+    } else {
+        emit(c, x, x_negated, if_true, next);
+    }
+    emit(c, y, y_negated, if_true, if_false);
+}
+
+// the conjuncts which are less likely to be true, for what they cost, are tested first
+static gint compare_conjuncts(gconstpointer a, gconstpointer b, gpointer data) {
+    Compiler *c = (Compiler *) data;
+    Estimate x = estimate(c, *(Wff **) a);
+    Estimate y = estimate(c, *(Wff **) b);
+    double rx = x.cost / (1 - x.p + 1e-9);
+    double ry = y.cost / (1 - y.p + 1e-9);
+    return rx < ry ? -1 : rx > ry;
+}
+
+Evaluator *compile_evaluator(Wff *wff) {
+    Evaluator *e = calloc(1, sizeof(Evaluator));
+    e->wff = wff;
+    Compiler c = {e, g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free), 0};
+
+    // an argument is the conjunction of its premises and of its conclusion
+    GPtrArray *conjuncts = g_ptr_array_new();
+    if (wff->type == WFF_ARGUMENT) {
+        for (GSList *list = wff->premises; list != NULL; list = list->next) {
+            g_ptr_array_add(conjuncts, list->data);
+        }
+        if (wff->wff1 != NULL) {
+            g_ptr_array_add(conjuncts, wff->wff1);
+        }
+    } else {
+        g_ptr_array_add(conjuncts, wff);
+    }
+    g_ptr_array_sort_with_data(conjuncts, compare_conjuncts, &c);
+
+    for (guint i = 0; i < conjuncts->len; i++) {
+        Wff *conjunct = g_ptr_array_index(conjuncts, i);
+        int next = i + 1 < conjuncts->len ? (int) (e->length + estimate(&c, conjunct).tests) : EVAL_TRUE;
+        emit(&c, conjunct, false, next, EVAL_FALSE);
+    }
+    e->start = e->length > 0 ? 0 : EVAL_TRUE;
+
+    GSList *formulae = NULL;
+    for (guint i = conjuncts->len; i-- > 0;) {
+        formulae = g_slist_prepend(formulae, g_ptr_array_index(conjuncts, i));
+    }
+    e->table = create_truth_table(formulae);
+    g_slist_free(formulae);
+
+    if (e->table == NULL && conjuncts->len > 0) {
+        Program *program = create_program();
+        for (guint i = 0; i < conjuncts->len; i++) {
+            emit_wff(program, g_ptr_array_index(conjuncts, i));
+            if (i > 0) {
+                emit_operator(program, OP_AND);
+            }
+        }
+        e->jit = compile_jit(program, JIT_BITS);
+        free_program(program);
+    }
+
+    g_ptr_array_free(conjuncts, TRUE);
+    g_hash_table_destroy(c.estimates);
+    return e;
+}
+
+void free_evaluator(Evaluator *e) {
+    if (e->table != NULL) {
+        free_truth_table(e->table);
+    }
+    free_jit(e->jit);
+    free(e->code);
+    free(e->atoms);
+    free(e);
+}
+
+bool run_evaluator(const Evaluator *e, const Valuation *values, char **error) {
+    for (size_t i = 0; i < e->words; i++) {
+        uint64_t assigned = i < values->words ? values->assigned[i] : 0;
+        if (e->atoms[i] & ~assigned) {
+            return valuate(e->wff, values, error);
+        }
+    }
+
+    if (e->table != NULL) {
+        return truth_table_value(e->table, values);
+    }
+    if (e->jit != NULL) {
+        return run_jit(e->jit, values->values) & 1;
+    }
+
+    const Test *code = e->code;
+    int pc = e->start;
+    while (pc >= 0) {
+        const Test *t = &code[pc];
+        pc = get_atom_value(values, t->atom) ? t->if_true : t->if_false;
+    }
+    return pc == EVAL_TRUE;
+}
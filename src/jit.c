@@ -0,0 +1,125 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "../include/jit.h"
+
+typedef uint64_t (*NativeFunc)(const uint64_t *words);
+
+struct Jit {
+    void *page;
+    size_t size;
+    NativeFunc run;
+};
+
+#if defined(__x86_64__) && !defined(_WIN32)
+
+static void emit_bytes(GArray *code, const guint8 *bytes, guint n) {
+    g_array_append_vals(code, bytes, n);
+}
+
+// rax = [rdi + offset], with the System V convention which passes words in rdi
+static void emit_load(GArray *code, uint32_t offset) {
+    const guint8 mov[] = {0x48, 0x8B, 0x87,
+                          offset & 0xFF, (offset >> 8) & 0xFF, (offset >> 16) & 0xFF, offset >> 24};
+    emit_bytes(code, mov, sizeof(mov));
+}
+
+Jit *compile_jit(const Program *program, JitLoads loads) {
+    static const guint8 push_rax[] = {0x50};
+    static const guint8 pop_rcx[] = {0x59};
+    static const guint8 not_rax[] = {0x48, 0xF7, 0xD0};
+    static const guint8 not_rcx[] = {0x48, 0xF7, 0xD1};
+    static const guint8 and_rax_rcx[] = {0x48, 0x21, 0xC8};
+    static const guint8 or_rax_rcx[] = {0x48, 0x09, 0xC8};
+    static const guint8 ret[] = {0xC3};
+
+    GArray *code = g_array_new(FALSE, FALSE, sizeof(guint8));
+    size_t depth = 0;
+    for (const Instruction *i = program->code, *end = program->code + program->length; i != end; i++) {
+        switch (i->op) {
+            case OP_ATOM:
+                // the lane below the new top is spilled
+                if (depth++ > 0) {
+                    emit_bytes(code, push_rax, sizeof(push_rax));
+                }
+                if (loads == JIT_COLUMNS) {
+                    emit_load(code, (uint32_t) i->slot * 8);
+                } else {
+                    int atom = g_array_index(program->atoms, int, i->slot);
+                    emit_load(code, (uint32_t) (atom >> 6) * 8);
+                    if (atom & 63) {
+                        // shr rax, atom % 64
+                        const guint8 shr[] = {0x48, 0xC1, 0xE8, atom & 63};
+                        emit_bytes(code, shr, sizeof(shr));
+                    }
+                }
+                break;
+            case OP_AND:
+                depth--;
+                emit_bytes(code, pop_rcx, sizeof(pop_rcx));
+                emit_bytes(code, and_rax_rcx, sizeof(and_rax_rcx));
+                break;
+            case OP_CONDITIONAL:
+                // the antecedent is the spilled lane
+                depth--;
+                emit_bytes(code, pop_rcx, sizeof(pop_rcx));
+                emit_bytes(code, not_rcx, sizeof(not_rcx));
+                emit_bytes(code, or_rax_rcx, sizeof(or_rax_rcx));
+                break;
+            case OP_NOT:
+                emit_bytes(code, not_rax, sizeof(not_rax));
+                break;
+            case OP_OR:
+                depth--;
+                emit_bytes(code, pop_rcx, sizeof(pop_rcx));
+                emit_bytes(code, or_rax_rcx, sizeof(or_rax_rcx));
+                break;
+        }
+    }
+    emit_bytes(code, ret, sizeof(ret));
+
+    // the page is written first, and then made executable, but never both
+    size_t size = code->len;
+    void *page = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED) {
+        g_array_free(code, TRUE);
+        return NULL;
+    }
+    memcpy(page, code->data, size);
+    g_array_free(code, TRUE);
+    if (mprotect(page, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(page, size);
+        return NULL;
+    }
+
+    Jit *jit = malloc(sizeof(Jit));
+    jit->page = page;
+    jit->size = size;
+    jit->run = (NativeFunc) page;
+    return jit;
+}
+
+void free_jit(Jit *jit) {
+    if (jit != NULL) {
+        munmap(jit->page, jit->size);
+        free(jit);
+    }
+}
+
+#else
+
+Jit *compile_jit(const Program *program, JitLoads loads) {
+    return NULL;
+}
+
+void free_jit(Jit *jit) {
+}
+
+#endif
+
+uint64_t run_jit(const Jit *jit, const uint64_t *words) {
+    return jit->run(words);
+}
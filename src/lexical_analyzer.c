@@ -3,320 +3,415 @@
  */
 #include <glib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "../include/lexical_analyzer.h"
+#include "../include/scan.h"
+#include "../include/symbols.h"
 #include "../include/token.h"
 
-static const char k_argument[] = "argument";
-static const char k_assert[] = "assert";
-static const char k_false[] = "false";
-static const char k_print[] = "print";
-static const char k_therefore[] = "therefore";
-static const char k_true[] = "true";
-static const char k_validate[] = "validate";
-static const char k_valuate[] = "valuate";
+Source *open_source(FILE *file, char **error) {
+    Source *source = malloc(sizeof(Source));
+    struct stat st;
+    int fd = fileno(file);
+    if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void *text = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (text != MAP_FAILED) {
+            madvise(text, (size_t) st.st_size, MADV_SEQUENTIAL);
+            source->text = text;
+            source->length = (size_t) st.st_size;
+            source->mapped = true;
+            return source;
+        }
+    }
 
-GQueue* g_queue_copy(GQueue* src) {
-    GQueue* dest = g_queue_new();
-    for (GList* l = src->head; l != NULL; l = l->next) {
-        g_queue_push_tail(dest, l->data);
+    // the streams which cannot be mapped, e.g., pipes, are read at once
+    GString *text = g_string_new(NULL);
+    char buffer[65536];
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+        g_string_append_len(text, buffer, n);
     }
-    return dest;
+    if (ferror(file)) {
+        *error = strdup("Failed to read the file");
+        g_string_free(text, TRUE);
+        free(source);
+        return NULL;
+    }
+    source->length = text->len;
+    source->text = g_string_free(text, FALSE);
+    source->mapped = false;
+    return source;
 }
 
-GQueue *tokenize_string(const char *str, char **error) {
-    FILE *f = fmemopen((void *) str, strlen(str), "r");
-    if (!f) {
-        perror("fmemopen failed");
-        exit(EXIT_FAILURE);
+void free_source(Source *source) {
+    if (source->mapped) {
+        munmap((void *) source->text, source->length);
+    } else {
+        g_free((char *) source->text);
     }
-    GQueue *tokens = tokenize(f, error);
-    fclose(f);
-    return tokens;
+    free(source);
+}
+
+TokenStream *tokenize_string(const char *str, char **error) {
+    return tokenize(str, strlen(str), error);
 }
 
-GQueue *tokenize(FILE *file, char **error) {
-    GQueue *tokens = g_queue_new();
-    GString *gs = g_string_new("");
+// the character at the position of the line, or '\0' beyond its end
+static char char_at(const char *line, size_t n, size_t i) {
+    return i < n ? line[i] : '\0';
+}
 
-    char line[MAX_LINE];
+// The lexer is a DFA over classes of characters. The end of a line is a class of its own, hence
+// the atom, the identifier, or the operator which ends a line is handled by the table too
+typedef enum {
+    C_OTHER,
+    C_SPACE,
+    C_UPPER,
+    C_LOWER,
+    C_DIGIT,
+    C_UNDERSCORE,
+    C_PRIME,
+    C_QUOTE,
+    C_LEFT_BRACKET,
+    C_RIGHT_BRACKET,
+    C_AND,
+    C_COMMA,
+    C_NOT,
+    C_OR,
+    C_COLON,
+    C_MINUS,
+    C_EQUAL,
+    C_GREATER,
+    C_END,
+    N_CLASSES
+} CharClass;
 
-    while (fgets(line, sizeof(line), file) != NULL) {
-        GQueue *queue = g_queue_new();
-        if (queue == NULL) {
-            *error = strdup("Failed to create the queue");
-            return NULL;
-        }
+static const uint8_t classes[256] = {
+        [' '] = C_SPACE, ['\t'] = C_SPACE,
+        ['A' ... 'Z'] = C_UPPER,
+        ['a' ... 'z'] = C_LOWER,
+        ['0' ... '9'] = C_DIGIT,
+        ['_'] = C_UNDERSCORE,
+        ['\''] = C_PRIME,
+        ['"'] = C_QUOTE,
+        ['('] = C_LEFT_BRACKET,
+        [')'] = C_RIGHT_BRACKET,
+        ['&'] = C_AND,
+        [','] = C_COMMA,
+        ['!'] = C_NOT, ['~'] = C_NOT,
+        ['|'] = C_OR,
+        [':'] = C_COLON,
+        ['-'] = C_MINUS,
+        ['='] = C_EQUAL,
+        ['>'] = C_GREATER
+};
 
-        bool in_atom = false;
-        bool in_identifier = false;
-        bool in_string = false;
-        int n_argument = 0;
-        int n_print = 0;
-        int n_therefore = 0;
-        int n_valuate = 0;
-        g_string_truncate(gs, 0);
+typedef enum {
+    S_START,
+    S_ATOM,
+    S_WORD,
+    S_STRING,
+    // after the first character of :=, ->, and =>
+    S_COLON,
+    S_MINUS,
+    S_EQUAL,
+    N_STATES
+} LexState;
 
-        const char *ptr = strstr(line, "//");
-        if (ptr) {
-            line[ptr - line] = '\0';
+typedef enum {
+    A_ERROR,
+    A_SKIP,
+    A_BEGIN,
+    A_BEGIN_STRING,
+    A_OPERATOR,
+    // ends the atom, and reads the character again from S_START
+    A_ATOM,
+    A_WORD,
+    A_STRING,
+    A_STRING_END,
+    A_ASSIGN,
+    A_MATERIAL_IMPLICATION,
+    A_THEREFORE
+} LexAction;
+
+typedef struct {
+    uint8_t next;
+    uint8_t action;
+} Transition;
+
+// the missing transitions are errors, i.e., unexpected characters
+static const Transition transitions[N_STATES][N_CLASSES] = {
+        [S_START] = {
+                [C_SPACE] = {S_START, A_SKIP},
+                [C_UPPER] = {S_ATOM, A_BEGIN},
+                [C_LOWER] = {S_WORD, A_BEGIN},
+                [C_QUOTE] = {S_STRING, A_BEGIN_STRING},
+                [C_LEFT_BRACKET] = {S_START, A_OPERATOR},
+                [C_RIGHT_BRACKET] = {S_START, A_OPERATOR},
+                [C_AND] = {S_START, A_OPERATOR},
+                [C_COMMA] = {S_START, A_OPERATOR},
+                [C_NOT] = {S_START, A_OPERATOR},
+                [C_OR] = {S_START, A_OPERATOR},
+                [C_COLON] = {S_COLON, A_SKIP},
+                [C_MINUS] = {S_MINUS, A_SKIP},
+                [C_EQUAL] = {S_EQUAL, A_SKIP},
+                [C_END] = {S_START, A_SKIP}
+        },
+        [S_ATOM] = {
+                [C_UPPER] = {S_ATOM, A_SKIP},
+                [C_DIGIT] = {S_ATOM, A_SKIP},
+                [C_UNDERSCORE] = {S_ATOM, A_SKIP},
+                [C_PRIME] = {S_ATOM, A_SKIP},
+                [C_SPACE] = {S_START, A_ATOM},
+                [C_RIGHT_BRACKET] = {S_START, A_ATOM},
+                [C_AND] = {S_START, A_ATOM},
+                [C_COMMA] = {S_START, A_ATOM},
+                [C_OR] = {S_START, A_ATOM},
+                [C_COLON] = {S_START, A_ATOM},
+                [C_MINUS] = {S_START, A_ATOM},
+                [C_END] = {S_START, A_ATOM}
+        },
+        // a word ends at any other character, which A_WORD checks
+        [S_WORD] = {
+                [C_OTHER ... C_UPPER] = {S_START, A_WORD},
+                [C_LOWER ... C_UNDERSCORE] = {S_WORD, A_SKIP},
+                [C_PRIME ... C_END] = {S_START, A_WORD}
+        },
+        [S_STRING] = {
+                [C_OTHER ... C_PRIME] = {S_STRING, A_SKIP},
+                [C_QUOTE] = {S_START, A_STRING},
+                [C_LEFT_BRACKET ... C_GREATER] = {S_STRING, A_SKIP},
+                [C_END] = {S_START, A_STRING_END}
+        },
+        [S_COLON] = {
+                [C_EQUAL] = {S_START, A_ASSIGN}
+        },
+        [S_MINUS] = {
+                [C_GREATER] = {S_START, A_MATERIAL_IMPLICATION}
+        },
+        [S_EQUAL] = {
+                [C_GREATER] = {S_START, A_THEREFORE}
         }
+};
 
-        for (int i = 0; line[i] != '\0' && line[i] != '\n'; i++) {
-            char c = line[i];
+// the run of characters which each state skips, if any, i.e., the characters of its loops
+static const uint8_t state_runs[N_STATES] = {
+        [S_START] = RUN_SPACES,
+        [S_ATOM] = RUN_ATOM,
+        [S_WORD] = RUN_WORD,
+        [S_STRING] = RUN_STRING,
+        [S_COLON] = N_RUNS,
+        [S_MINUS] = N_RUNS,
+        [S_EQUAL] = N_RUNS
+};
 
-            // first we deal with some special cases
-            if (in_atom) {
-                if (c == ' ' || c == '\t' || c == '&' || c == ')' || c == ',' ||
-                    c == ':' || c == '-' || c == '|') {
-                    g_queue_push_tail(queue, create_atom_token(gs->str));
-                    in_atom = false;
-                } else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
-                           c == '_' || c == '\'') {
-                    g_string_append_c(gs, c);
-                    continue;
-                } else {
-                    asprintf(error,
-                             "Unexpected character '%c' at position %d of line '%s'",
-                             c, i, line);
-                    return NULL;
-                }
-            }
+// The keywords are found by a perfect hash of their length, and of their first and last letters,
+// which gives each one a slot of its own: a word is a keyword if it equals the keyword of its
+// slot. A keyword which is once can appear only once in a line
+typedef struct {
+    const char *word;
+    size_t length;
+    TokenType type;
+    bool once;
+} Keyword;
 
-            if (in_identifier) {
-                if (c == ' ' || c == '\t') {
-                    g_queue_push_tail(queue, create_identifier_token(gs->str));
-                    in_identifier = false;
-                } else if (c >= 'a' && c <= 'z' || c >= '0' && c <= '9' ||
-                           c == '_') {
-                    g_string_append_c(gs, c);
-                    continue;
-                } else {
-                    asprintf(error,
-                             "Unexpected character '%c' at position %d of line '%s'",
-                             c, i, line);
-                    return NULL;
-                }
-            }
+#define KEYWORD_SLOTS 16
 
-            if (in_string) {
-                if (c == '"') {
-                    g_queue_push_tail(queue, create_string_token(gs->str));
-                    in_string = false;
-                } else {
-                    if (i == strlen(line) - 1) {
-                        asprintf(error,
-                                 "Unexpected character '%c' at position %d of line '%s'",
-                                 c, i, line);
-                        return NULL;
-                    }
-                    g_string_append_c(gs, c);
-                }
-                continue;
-            }
+static size_t keyword_hash(const char *word, size_t length) {
+    return (length + 7 * (unsigned char) word[0] + (unsigned char) word[length - 1]) & (KEYWORD_SLOTS - 1);
+}
 
-            // spaces are ignored except when parsing a string
-            if (c == ' ' || c == '\t') {
-                continue;
+static const Keyword keywords[KEYWORD_SLOTS] = {
+        [1] = {"assert", 6, TOKEN_ASSERT, false},
+        [3] = {"argument", 8, TOKEN_ARGUMENT, true},
+        [4] = {"false", 5, TOKEN_FALSE, false},
+        [5] = {"true", 4, TOKEN_TRUE, false},
+        [6] = {"valuate", 7, TOKEN_VALUATE, true},
+        [7] = {"validate", 8, TOKEN_VALIDATE, false},
+        [9] = {"print", 5, TOKEN_PRINT, true},
+        [10] = {"therefore", 9, TOKEN_THEREFORE, true},
+        [13] = {"export", 6, TOKEN_EXPORT, false},
+        [14] = {"count", 5, TOKEN_COUNT, false}
+};
+
+static const Keyword *find_keyword(const char *word, size_t length) {
+    const Keyword *k = &keywords[keyword_hash(word, length)];
+    return k->length == length && memcmp(k->word, word, length) == 0 ? k : NULL;
+}
+
+static TokenType operator_type(char c) {
+    switch (c) {
+        case '(':
+            return TOKEN_LEFT_BRACKET;
+        case ')':
+            return TOKEN_RIGHT_BRACKET;
+        case '&':
+            return TOKEN_AND;
+        case ',':
+            return TOKEN_COMMA;
+        case '|':
+            return TOKEN_OR;
+        default:
+            return TOKEN_NOT;
+    }
+}
+
+// the line's tokens, from the first one of the statement, are checked against the grammar of
+// the statements, i.e., its first tokens, and the tokens which can follow each other
+static bool check_statement(const TokenStream *stream, size_t first, const char *line, size_t n, char **error) {
+    size_t end = stream->n_tokens;
+    for (size_t k = first; k < end; k++) {
+        // the position of the token in the line, counting from 1
+        int i = (int) (k - first + 1);
+        TokenType type = (TokenType) stream->types[k];
+        if (k == first) {
+            if (type != TOKEN_PRINT && k + 1 == end) {
+                asprintf(error, "Unexpected end of line at line '%.*s'",
+                         (int) n, line);
+                return false;
             }
 
-            if (c == '"') {
-                in_string = true;
-                g_string_truncate(gs, 0);
-            } else if (c == '(') {
-                g_queue_push_tail(queue, create_left_bracket_token());
-            } else if (c == ')') {
-                g_queue_push_tail(queue, create_right_bracket_token());
-            } else if (c == '&') {
-                g_queue_push_tail(queue, create_and_token());
-            } else if (c == ',') {
-                g_queue_push_tail(queue, create_comma_token());
-            } else if (c == '!' || c == '~') {
-                g_queue_push_tail(queue, create_not_token());
-            } else if (c == '|') {
-                g_queue_push_tail(queue, create_or_token());
-            } else if (c == ':') {
-                if (line[++i] == '=') {
-                    g_queue_push_tail(queue, create_assign_token());
-                } else {
-                    asprintf(error,
-                             "Unexpected character '%c' at position %d of line '%s'",
-                             line[i], i, line);
-                    return NULL;
-                }
-            } else if (c == '-') {
-                if (line[++i] == '>') {
-                    g_queue_push_tail(queue,
-                                      create_material_implication_token());
-                } else {
-                    asprintf(error,
-                             "Unexpected character '%c' at position %d of line '%s'",
-                             line[i], i, line);
-                    return NULL;
-                }
-            } else if (c == '=') {
-                if (line[++i] == '>') {
-                    g_queue_push_tail(queue, create_therefore_token());
-                } else {
+            if (type == TOKEN_ATOM) {
+                if (stream->types[k + 1] != TOKEN_ASSIGN) {
+                    Token next_token = get_token(stream, k + 1);
                     asprintf(error,
-                             "Unexpected character '%c' at position %d of line '%s'",
-                             line[i], i, line);
-                    return NULL;
-                }
-            } else if (c >= 'A' && c <= 'Z') {
-                in_atom = true;
-                g_string_truncate(gs, 0);
-                g_string_append_c(gs, c);
-            } else if (c >= 'a' && c <= 'z') {
-                // search for a keyword
-                bool found = false;
-                if (strncmp(line + i, k_argument, strlen(k_argument)) == 0) {
-                    if (n_argument == 1) {
-                        asprintf(error,
-                                 "Unexpected symbol 'argument' at position %d of line '%s'",
-                                 i, line);
-                        return NULL;
-                    }
-                    n_argument++;
-                    g_queue_push_tail(queue, create_argument_token());
-                    i += strlen(k_argument);
-                    found = true;
-                } else if (strncmp(line + i, k_assert, strlen(k_assert)) == 0) {
-                    g_queue_push_tail(queue, create_assert_token());
-                    i += strlen(k_assert);
-                    found = true;
-                } else if (strncmp(line + i, k_false, strlen(k_false)) == 0) {
-                    g_queue_push_tail(queue, create_false_token());
-                    i += strlen(k_false);
-                    found = true;
-                } else if (strncmp(line + i, k_print, strlen(k_print)) == 0) {
-                    if (n_print == 1) {
-                        asprintf(error,
-                                 "Unexpected symbol 'print' at position %d of line '%s'",
-                                 i, line);
-                        return NULL;
-                    }
-                    g_queue_push_tail(queue, create_print_token());
-                    n_print++;
-                    i += strlen(k_print);
-                    found = true;
-                } else if (
-                        strncmp(line + i, k_therefore, strlen(k_therefore)) ==
-                        0) {
-                    if (n_therefore == 1) {
-                        asprintf(error,
-                                 "Unexpected symbol 'therefore' at position %d of line '%s'",
-                                 i, line);
-                        return NULL;
-                    }
-                    n_therefore++;
-                    g_queue_push_tail(queue, create_therefore_token());
-                    i += strlen(k_therefore);
-                    found = true;
-                } else if (strncmp(line + i, k_true, strlen(k_true)) == 0) {
-                    g_queue_push_tail(queue, create_true_token());
-                    i += strlen(k_true);
-                    found = true;
-                } else if (strncmp(line + i, k_validate, strlen(k_validate)) ==
-                           0) {
-                    g_queue_push_tail(queue, create_validate_token());
-                    i += strlen(k_validate);
-                    found = true;
-                } else if (strncmp(line + i, k_valuate, strlen(k_valuate)) ==
-                           0) {
-                    if (n_valuate == 1) {
-                        asprintf(error,
-                                 "Unexpected symbol 'valuate' at position %d of line '%s'",
-                                 i, line);
-                        return NULL;
-                    }
-                    g_queue_push_tail(queue, create_valuate_token());
-                    n_valuate++;
-                    i += strlen(k_valuate);
-                    found = true;
+                             "Unexpected symbol '%.*s' at position %d of line '%.*s'",
+                             (int) next_token.length, next_token.text, i, (int) n, line);
+                    return false;
                 }
-                if (found) {
-                    if (line[i] != ' ' && line[i] != '\t' && line[i] != '\n') {
-                        asprintf(error,
-                                 "Unexpected character '%c' at position %d of line '%s'",
-                                 line[i], i, line);
-                        return NULL;
-                    }
-                } else {
-                    in_identifier = true;
-                    g_string_truncate(gs, 0);
-                    g_string_append_c(gs, c);
-                }
-            } else {
+            } else if (!(type == TOKEN_ARGUMENT ||
+                         type == TOKEN_ASSERT ||
+                         type == TOKEN_COUNT ||
+                         type == TOKEN_EXPORT ||
+                         type == TOKEN_PRINT ||
+                         type == TOKEN_VALUATE ||
+                         type == TOKEN_VALIDATE)
+                    ) {
+                Token token = get_token(stream, k);
                 asprintf(error,
-                         "Unexpected character '%c' at position %d of line '%s'",
-                         c, i, line);
-                return NULL;
+                         "Unexpected symbol '%.*s' at position %d of line '%.*s'",
+                         (int) token.length, token.text, i, (int) n, line);
+                return false;
             }
         }
-
-        // an atom or an identifier can be the last item of a line
-        if (in_atom) {
-            g_queue_push_tail(queue, create_atom_token(gs->str));
-        } else if (in_identifier) {
-            g_queue_push_tail(queue, create_identifier_token(gs->str));
+        if (k + 1 < end && !can_follow(type, (TokenType) stream->types[k + 1])) {
+            Token next_token = get_token(stream, k + 1);
+            asprintf(error,
+                     "Unexpected symbol '%.*s' at position %d of line '%.*s'",
+                     (int) next_token.length, next_token.text, i, (int) n, line);
+            return false;
         }
+    }
+    return true;
+}
+
+TokenStream *tokenize(const char *text, size_t length, char **error) {
+    // the spans of the tokens are 32-bit offsets
+    if (length > UINT32_MAX) {
+        *error = strdup("The script is larger than 4 GiB");
+        return NULL;
+    }
+    TokenStream *stream = create_token_stream(text);
+    get_scan_kernel();
 
-        if (queue->length == 0) continue;
+    for (size_t start = 0; start < length;) {
+        // the line, with its newline if any, which is not copied
+        const char *line = text + start;
+        size_t comment;
+        size_t n = scan_line(line, length - start, &comment);
+        start += n;
 
-        // validates the line's syntax
-        GQueue *list = g_queue_new();
-        Token *token;
-        for (int i = 1; (token = (Token *) g_queue_pop_head(queue)) != NULL; i++) {
-            if (g_queue_is_empty(list)) {
-                Token *next_token = (Token *) g_queue_peek_head(queue);
-                if (token->type != TOKEN_PRINT && next_token == NULL) {
-                    asprintf(error, "Unexpected end of line at line '%s'",
-                             line);
+        // the first token of the line, where the current atom, word, or string begins, and the
+        // keywords met so far
+        size_t first = stream->n_tokens;
+        size_t offset = (size_t) (line - text);
+        size_t begin = 0;
+        bool seen[KEYWORD_SLOTS] = {false};
+
+        n = comment;
+        size_t end = n > 0 && line[n - 1] == '\n' ? n - 1 : n;
+
+        LexState state = S_START;
+        for (size_t i = 0; i <= end;) {
+            CharClass class = i < end ? classes[(unsigned char) line[i]] : C_END;
+            Transition t = transitions[state][class];
+            if (t.action == A_ERROR) {
+                asprintf(error,
+                         "Unexpected character '%c' at position %zu of line '%.*s'",
+                         char_at(line, n, i), i, (int) n, line);
+                free_token_stream(stream);
+                return NULL;
+            }
+
+            if (t.action == A_BEGIN) {
+                begin = i;
+            } else if (t.action == A_BEGIN_STRING) {
+                begin = i + 1;
+            } else if (t.action == A_OPERATOR) {
+                add_token(stream, operator_type(line[i]), offset + i, 1, -1);
+            } else if (t.action == A_ATOM) {
+                add_token(stream, TOKEN_ATOM, offset + begin, i - begin, intern_atom_span(line + begin, i - begin));
+                state = S_START;
+                continue;
+            } else if (t.action == A_WORD) {
+                const Keyword *k = find_keyword(line + begin, i - begin);
+                if (k != NULL && k->once && seen[k - keywords]) {
+                    asprintf(error,
+                             "Unexpected symbol '%s' at position %zu of line '%.*s'",
+                             k->word, begin, (int) n, line);
+                    free_token_stream(stream);
                     return NULL;
                 }
-
-                if (token->type == TOKEN_ATOM) {
-                    if (next_token->type != TOKEN_ASSIGN) {
-                        asprintf(error,
-                                 "Unexpected symbol '%s' at position %d of line '%s'",
-                                 next_token->value, i, line);
-                        return NULL;
-                    }
-                } else if (!(token->type == TOKEN_ARGUMENT ||
-                             token->type == TOKEN_ASSERT ||
-                             token->type == TOKEN_PRINT ||
-                             token->type == TOKEN_VALUATE ||
-                             token->type == TOKEN_VALIDATE)
-                        ) {
+                // a word is followed by a space, or a newline, but an identifier can also end the text
+                char c = char_at(line, n, i);
+                if (c != ' ' && c != '\t' && c != '\n' && (k != NULL || class != C_END)) {
                     asprintf(error,
-                             "Unexpected symbol '%s' at position %d of line '%s'",
-                             token->value, i, line);
+                             "Unexpected character '%c' at position %zu of line '%.*s'",
+                             c, i, (int) n, line);
+                    free_token_stream(stream);
                     return NULL;
                 }
-            }
-            Token *next_token = (Token *) g_queue_peek_head(queue);
-            if (next_token == NULL || can_follow(token, next_token)) {
-                g_queue_push_tail(list, token);
-            } else {
+                if (k != NULL) {
+                    seen[k - keywords] = true;
+                }
+                add_token(stream, k != NULL ? k->type : TOKEN_IDENTIFIER, offset + begin, i - begin, -1);
+            } else if (t.action == A_STRING) {
+                add_token(stream, TOKEN_STRING, offset + begin, i - begin, -1);
+            } else if (t.action == A_STRING_END && end == n && begin < n) {
+                // a string which is still open at the end of the text, or at a comment
                 asprintf(error,
-                         "Unexpected symbol '%s' at position %d of line '%s'",
-                         next_token->value, i, line);
+                         "Unexpected character '%c' at position %zu of line '%.*s'",
+                         line[n - 1], n - 1, (int) n, line);
+                free_token_stream(stream);
                 return NULL;
+            } else if (t.action == A_ASSIGN) {
+                add_token(stream, TOKEN_ASSIGN, offset + i - 1, 2, -1);
+            } else if (t.action == A_MATERIAL_IMPLICATION) {
+                add_token(stream, TOKEN_MATERIAL_IMPLICATION, offset + i - 1, 2, -1);
+            } else if (t.action == A_THEREFORE) {
+                add_token(stream, TOKEN_THEREFORE, offset + i - 1, 2, -1);
+            }
+            state = (LexState) t.next;
+            i++;
+            // the characters which keep the state are skipped at once
+            if (state_runs[state] != N_RUNS) {
+                i = skip_run((Run) state_runs[state], line, i, end);
             }
         }
 
-        g_queue_push_tail(tokens, g_queue_copy(list));
+        if (stream->n_tokens == first) continue;
 
-        g_queue_clear(list);
-        g_queue_clear(queue);
+        // validates the line's syntax
+        if (!check_statement(stream, first, line, n, error)) {
+            free_token_stream(stream);
+            return NULL;
+        }
+        end_statement(stream);
     }
 
-    fclose(file);
-
-    g_string_free(gs, TRUE);
-
     *error = NULL;
-    return tokens;
+    return stream;
 }
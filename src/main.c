@@ -5,35 +5,114 @@
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include "../include/arena.h"
+#include "../include/dimacs.h"
+#include "../include/engine.h"
 #include "../include/lexical_analyzer.h"
 #include "../include/parser.h"
+#include "../include/scan.h"
+#include "../include/sweep.h"
+#include "../include/truth_table.h"
+#include "../include/unique.h"
+#include "../include/verdict_cache.h"
+
+static const char usage[] = "Usage: aris-pl [-c cache] [-d] [-e auto|bdd|sat|table|tableau] [-j threads] [-s] <filename>\n";
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: aris-pl <filename>\n");
+    int opt;
+    char *cache = NULL;
+    bool dimacs = false;
+    while ((opt = getopt(argc, argv, "c:de:j:s")) != -1) {
+        if (opt == 'c') {
+            cache = optarg;
+        } else if (opt == 'd') {
+            dimacs = true;
+        } else if (opt == 'e') {
+            Engine engine;
+            if (!engine_from_string(optarg, &engine)) {
+                fprintf(stderr, "Unknown engine '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            set_engine(engine);
+        } else if (opt == 'j') {
+            char *end;
+            long n = strtol(optarg, &end, 10);
+            if (*end != '\0' || n < 0) {
+                fprintf(stderr, "Invalid number of threads '%s'\n", optarg);
+                return EXIT_FAILURE;
+            }
+            set_sweep_threads((int) n);
+        } else if (opt == 's') {
+            set_simplification_report(true);
+        } else {
+            fputs(usage, stderr);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 1) {
+        fputs(usage, stderr);
         return EXIT_FAILURE;
     }
 
-    FILE *file = fopen(argv[1], "r");
+    FILE *file = fopen(argv[optind], "r");
     if (!file) {
         perror("Failed to open file");
         return EXIT_FAILURE;
     }
 
-    char *error = NULL;
-    GQueue *tokens = tokenize(file, &error);
+    init_sweep();
+    init_scan();
 
-    if (error) {
+    char *error = NULL;
+    if (cache != NULL && !open_verdict_cache(cache, &error)) {
         fprintf(stderr, "%s\n", error);
         free(error);
         return EXIT_FAILURE;
     }
 
-    fclose(file);
+    // the wffs of the script are released at once, when it ends
+    Arena *arena = create_arena();
+    set_arena(arena);
+    Source *source = NULL;
+
+    // a DIMACS file is a single set of clauses, which is only checked for satisfiability
+    if (dimacs) {
+        Wff *argument = read_dimacs(file, &error);
+        fclose(file);
+        bool satisfiable = error == NULL && is_satisfiable(argument->premises, &error);
+        if (error) {
+            fprintf(stderr, "%s\n", error);
+            free(error);
+            return EXIT_FAILURE;
+        }
+        printf("s %s\n", satisfiable ? "SATISFIABLE" : "UNSATISFIABLE");
+    } else {
+        // the tokens point into the script, which is kept until the end
+        source = open_source(file, &error);
+        fclose(file);
+        TokenStream *tokens = source != NULL ? tokenize(source->text, source->length, &error) : NULL;
 
-    if (tokens != NULL) {
-        parse(tokens);
+        if (error) {
+            fprintf(stderr, "%s\n", error);
+            free(error);
+            return EXIT_FAILURE;
+        }
+
+        if (tokens != NULL) {
+            parse(tokens);
+            free_token_stream(tokens);
+        }
+    }
+    end_solver_session();
+    clear_truth_tables();
+    clear_unique_table();
+    free_arena(arena);
+    if (source != NULL) {
+        free_source(source);
     }
+    close_verdict_cache();
 
     return EXIT_SUCCESS;
 }
@@ -4,89 +4,295 @@
 #include <glib.h>
 #include <stdbool.h>
 #include <printf.h>
+#include "../include/counter.h"
+#include "../include/dimacs.h"
+#include "../include/evaluator.h"
 #include "../include/parser.h"
+#include "../include/pool.h"
+#include "../include/sweep.h"
 #include "../include/token.h"
+#include "../include/unique.h"
+#include "../include/verdict_cache.h"
 
-int parse(GQueue *all_tokens) {
-    GHashTable *arguments = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, free_wff);
+// looks up the verdict of a command on an argument which is equal to the given one, up to the
+// order of its premises and of the operands of & and |, and then in the verdict cache, if any
+static bool cached_verdict(GHashTable *verdicts, const char *command, const Wff *argument, bool *verdict) {
+    char *key = argument_key(argument);
+    if (key == NULL) {
+        return lookup_verdict(command, argument, verdict);
+    }
+    char *k = g_strconcat(command, key, NULL);
+    gpointer value;
+    bool found = g_hash_table_lookup_extended(verdicts, k, NULL, &value);
+    if (found) {
+        *verdict = GPOINTER_TO_INT(value);
+    } else if (lookup_verdict(command, argument, verdict)) {
+        g_hash_table_insert(verdicts, k, GINT_TO_POINTER(*verdict));
+        k = NULL;
+        found = true;
+    }
+    g_free(k);
+    g_free(key);
+    return found;
+}
+
+static void cache_verdict(GHashTable *verdicts, const char *command, const Wff *argument, bool verdict) {
+    char *key = argument_key(argument);
+    if (key != NULL) {
+        g_hash_table_insert(verdicts, g_strconcat(command, key, NULL), GINT_TO_POINTER(verdict));
+        g_free(key);
+    }
+    store_verdict(command, argument, verdict);
+}
+
+// A statement of the script, whose output is printed in the order of the script once it is done.
+// The decisions, i.e., assert, validate, count, and export, read nothing but the argument which
+// was defined by their name when they were met, hence they run on the pool, while the others run
+// at once, in order
+typedef struct {
+    TokenType type;
+    char *name;
+    Wff *argument;
+    // the verdict of assert and validate, and whether it was found in a cache
+    bool verdict;
+    bool cached;
+    char *models;
+    char *counterexamples;
+    int n_atoms;
+    char *output;
+    char *error;
+    int ticket;
+} Statement;
+
+static Statement *create_statement(TokenType type, char *name, Wff *argument) {
+    Statement *s = g_new0(Statement, 1);
+    s->type = type;
+    s->name = name;
+    s->argument = argument;
+    s->ticket = -1;
+    return s;
+}
+
+static void free_statement(Statement *s) {
+    g_free(s->models);
+    g_free(s->counterexamples);
+    free(s->output);
+    free(s->error);
+    g_free(s);
+}
+
+static void run_statement(gpointer data) {
+    Statement *s = (Statement *) data;
+    if (s->type == TOKEN_ASSERT) {
+        s->verdict = is_tautology(s->argument, &s->error);
+    } else if (s->type == TOKEN_VALIDATE) {
+        s->verdict = is_valid(s->argument, &s->error);
+    } else if (s->type == TOKEN_COUNT) {
+        count_argument(s->argument, &s->models, &s->counterexamples, &s->n_atoms);
+    } else if (s->type == TOKEN_EXPORT) {
+        size_t length;
+        FILE *stream = open_memstream(&s->output, &length);
+        write_dimacs(stream, s->argument);
+        fclose(stream);
+    }
+}
+
+static bool is_decision(TokenType type) {
+    return type == TOKEN_ASSERT || type == TOKEN_VALIDATE || type == TOKEN_COUNT || type == TOKEN_EXPORT;
+}
+
+// prints the output of a done statement, and records its verdict, or prints its error and returns false
+static bool finish_statement(Statement *s, GHashTable *verdicts, GHashTable *assertions, GHashTable *validations) {
+    if (s->error) {
+        if (s->type == TOKEN_ASSERT) {
+            fprintf(stderr, "Unexpected symbol '%s'\n", s->error);
+        } else {
+            fprintf(stderr, "%s\n", s->error);
+        }
+        return false;
+    }
+
+    Wff *arg = s->argument;
+    if (s->type == TOKEN_ASSERT) {
+        if (!s->cached) {
+            cache_verdict(verdicts, "t", arg, s->verdict);
+        }
+        g_hash_table_insert(assertions, s->name, GINT_TO_POINTER(s->verdict));
+        printf("argument \"%s\" is %sa tautology\n", wff_to_string((Wff *) ((GSList *) arg->premises)->data), s->verdict ? "" : "not ");
+    } else if (s->type == TOKEN_VALIDATE) {
+        if (!s->cached) {
+            cache_verdict(verdicts, "v", arg, s->verdict);
+        }
+        g_hash_table_insert(validations, s->name, GINT_TO_POINTER(s->verdict));
+        printf("argument \"%s\" is %s\n", wff_to_string(arg), s->verdict ? "valid" : "invalid");
+    } else if (s->type == TOKEN_COUNT) {
+        if (s->counterexamples == NULL) {
+            printf("argument \"%s\" has %s models over %d atoms\n",
+                   wff_to_string((Wff *) ((GSList *) arg->premises)->data), s->models, s->n_atoms);
+        } else {
+            printf("argument \"%s\" has %s models of its premises over %d atoms, %s of which are counterexamples\n",
+                   wff_to_string(arg), s->models, s->n_atoms, s->counterexamples);
+        }
+    } else if (s->output != NULL) {
+        fputs(s->output, stdout);
+    }
+    return true;
+}
+
+int parse(const TokenStream *stream) {
+    // the redefined arguments are not released, since the statements which are still running may read them
+    GHashTable *arguments = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
     GHashTable *assertions = g_hash_table_new(g_str_hash, g_str_equal);
     GHashTable *validations = g_hash_table_new(g_str_hash, g_str_equal);
     GHashTable *valuations = g_hash_table_new(g_str_hash, g_str_equal);
-    GHashTable *values = g_hash_table_new(g_str_hash, g_str_equal);
+    // the arguments compiled for valuate, by name
+    GHashTable *evaluators = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify) free_evaluator);
+    Valuation *values = create_valuation();
+    // the verdicts of validate and assert, by canonical key of the argument
+    GHashTable *verdicts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+    // the decisions share the threads of -j, if there are at least two of them, and each one sweeps
+    // on its thread alone, hence a script with a single decision runs it as before
+    int n_decisions = 0;
+    for (size_t i = 0; i < stream->n_statements; i++) {
+        n_decisions += is_decision((TokenType) stream->types[stream->statements[i]]);
+    }
+    int n_threads = get_sweep_threads();
+    if (n_threads > n_decisions) {
+        n_threads = n_decisions;
+    }
+    Pool *pool = n_threads > 1 ? create_pool(n_threads, run_statement) : NULL;
+    // the statements whose output is not printed yet, in the order of the script
+    GQueue *pending = g_queue_new();
+    // the names of the arguments, which are spans of the script in the tokens
+    GPtrArray *names = g_ptr_array_new_with_free_func(g_free);
 
     char *error = NULL;
-    for (GQueue *tokens; (tokens = (GQueue *) g_queue_pop_head(all_tokens)) != NULL;) {
-        Token *token = (Token *) g_queue_pop_head(tokens);
-
-        if (token->type == TOKEN_PRINT) {
-            if (g_queue_peek_head(tokens) != NULL) {
-                printf("%s\n", ((Token *) g_queue_pop_head(tokens))->value);
-            } else {
-                printf("\n");
-            }
-            continue;
-        }
+    int status = EXIT_SUCCESS;
+    for (size_t line = 0; status == EXIT_SUCCESS && line < stream->n_statements; line++) {
+        TokenCursor tokens = statement_cursor(stream, line);
+        Token token;
+        pop_token(&tokens, &token);
+        Statement *s = NULL;
 
-        Token *next_token = (Token *) g_queue_pop_head(tokens);
-        if (token->type == TOKEN_ATOM) {
-            if (next_token->type == TOKEN_ASSIGN) {
-                Token *t = (Token *) g_queue_pop_head(tokens);
-                g_hash_table_insert(values, g_strdup(token->value), GINT_TO_POINTER(t->type == TOKEN_TRUE));
+        if (token.type == TOKEN_PRINT) {
+            s = create_statement(token.type, NULL, NULL);
+            Token t;
+            bool found = pop_token(&tokens, &t);
+            asprintf(&s->output, "%.*s\n", found ? (int) t.length : 0, found ? t.text : "");
+        } else {
+            Token next_token;
+            pop_token(&tokens, &next_token);
+            char *name = NULL;
+            if (next_token.type == TOKEN_IDENTIFIER) {
+                name = g_strndup(next_token.text, next_token.length);
+                g_ptr_array_add(names, name);
             }
-        } else if (token->type == TOKEN_ARGUMENT) {
-            g_queue_pop_head(tokens);
-            Wff *argument = create_argument();
-            while (!g_queue_is_empty(tokens)) {
-                Wff *formula = parse_wff(tokens, &error);
-                if (error) {
-                    fprintf(stderr, "Unexpected symbol '%s'\n", error);
-                    return EXIT_FAILURE;
+            if (token.type == TOKEN_ATOM) {
+                Token t;
+                if (next_token.type == TOKEN_ASSIGN && pop_token(&tokens, &t)) {
+                    set_atom_value(values, token.atom, t.type == TOKEN_TRUE);
                 }
-                if (formula == NULL) {
-                    Token *t = (Token *) g_queue_pop_head(tokens);
-                    if (t->type != TOKEN_RIGHT_BRACKET && argument->wff1 != NULL) {
-                        fprintf(stderr, "Unexpected symbol\n");
-                        return EXIT_FAILURE;
+            } else if (token.type == TOKEN_ARGUMENT) {
+                pop_token(&tokens, NULL);
+                Wff *argument = create_argument();
+                s = create_statement(token.type, NULL, NULL);
+                // a string is the path of a DIMACS CNF file, whose clauses are the premises
+                Token t;
+                if (peek_token(&tokens, &t) && t.type == TOKEN_STRING) {
+                    pop_token(&tokens, NULL);
+                    char *path = g_strndup(t.text, t.length);
+                    argument = load_dimacs(path, &s->error);
+                    g_free(path);
+                    if (s->error == NULL && peek_token(&tokens, &t)) {
+                        asprintf(&s->error, "Unexpected symbol '%.*s'", (int) t.length, t.text);
                     }
-                    if (t->type == TOKEN_THEREFORE) {
-                        argument->wff1 = parse_wff(tokens, &error);
-                        if (error) {
-                            fprintf(stderr, "Unexpected symbol '%s'\n", error);
-                            return EXIT_FAILURE;
+                }
+                while (s->error == NULL && peek_token(&tokens, NULL)) {
+                    Wff *formula = parse_wff(&tokens, &error);
+                    if (error == NULL && formula == NULL) {
+                        Token t;
+                        pop_token(&tokens, &t);
+                        if (t.type != TOKEN_RIGHT_BRACKET && argument->wff1 != NULL) {
+                            s->error = strdup("Unexpected symbol");
+                        } else if (t.type == TOKEN_THEREFORE) {
+                            argument->wff1 = parse_wff(&tokens, &error);
                         }
+                    } else if (error == NULL) {
+                        add_premise_to_argument(argument, formula);
+                    }
+                    if (error) {
+                        asprintf(&s->error, "Unexpected symbol '%s'", error);
+                        free(error);
+                        error = NULL;
                     }
-                } else {
-                    add_premise_to_argument(argument, formula);
+                }
+                if (s->error == NULL) {
+                    g_hash_table_remove(evaluators, name);
+                    g_hash_table_insert(arguments, g_strdup(name), argument);
+                }
+            } else if (is_decision(token.type)) {
+                Wff *arg = (Wff *) g_hash_table_lookup(arguments, name);
+                s = create_statement(token.type, name, arg);
+                if (token.type == TOKEN_ASSERT || token.type == TOKEN_VALIDATE) {
+                    s->cached = cached_verdict(verdicts, token.type == TOKEN_ASSERT ? "t" : "v", arg, &s->verdict);
+                }
+                if (!s->cached) {
+                    if (pool != NULL) {
+                        s->ticket = submit_job(pool, s);
+                    } else {
+                        run_statement(s);
+                    }
+                }
+            } else if (token.type == TOKEN_VALUATE) {
+                char *id = name;
+                Wff *arg = (Wff *) g_hash_table_lookup(arguments, id);
+                Evaluator *evaluator = g_hash_table_lookup(evaluators, id);
+                if (evaluator == NULL) {
+                    evaluator = compile_evaluator(arg);
+                    g_hash_table_insert(evaluators, g_strdup(id), evaluator);
+                }
+                s = create_statement(token.type, id, arg);
+                bool b = run_evaluator(evaluator, values, &s->error);
+                if (!s->error) {
+                    g_hash_table_insert(valuations, id, GINT_TO_POINTER(b));
+                    asprintf(&s->output, "argument \"%s\" is %s\n", wff_to_string(arg), b ? "true" : "false");
                 }
             }
-            g_hash_table_insert(arguments, g_strdup(next_token->value), argument);
-        } else if (token->type == TOKEN_ASSERT) {
-            Wff *arg = (Wff *) g_hash_table_lookup(arguments, next_token->value);
-            bool b = is_tautology(arg, &error);
-            if (error) {
-                fprintf(stderr, "Unexpected symbol '%s'\n", error);
-                return EXIT_FAILURE;
+        }
+        if (s != NULL) {
+            g_queue_push_tail(pending, s);
+        }
+
+        // the statements at the head which are done are printed, and those which are running are
+        // waited for only when a later statement failed, or at the end
+        bool failed = s != NULL && s->error != NULL;
+        for (Statement *head; status == EXIT_SUCCESS && (head = g_queue_peek_head(pending)) != NULL;) {
+            if (head->ticket >= 0) {
+                if (!failed && !job_done(pool, head->ticket)) {
+                    break;
+                }
+                wait_job(pool, head->ticket);
             }
-            g_hash_table_insert(assertions, next_token->value, GINT_TO_POINTER(b));
-            printf("argument \"%s\" is %sa tautology\n", wff_to_string((Wff *) ((GSList *) arg->premises)->data), b ? "" : "not ");
-        } else if (token->type == TOKEN_VALIDATE) {
-            char *id = next_token->value;
-            Wff *arg = (Wff *) g_hash_table_lookup(arguments, id);
-            bool b = is_valid(arg, &error);
-            g_hash_table_insert(validations, id, GINT_TO_POINTER(b));
-            printf("argument \"%s\" is %s\n", wff_to_string(arg), b ? "valid" : "invalid");
-        } else if (token->type == TOKEN_VALUATE) {
-            char *id = next_token->value;
-            Wff *arg = (Wff *) g_hash_table_lookup(arguments, id);
-            bool b = valuate(arg, values, &error);
-            if (error) {
-                fprintf(stderr, "%s\n", error);
-                return EXIT_FAILURE;
+            if (!finish_statement(head, verdicts, assertions, validations)) {
+                status = EXIT_FAILURE;
             }
-            g_hash_table_insert(valuations, id, GINT_TO_POINTER(b));
-            printf("argument \"%s\" is %s\n", wff_to_string(arg), b ? "true" : "false");
+            free_statement(g_queue_pop_head(pending));
+        }
+    }
+
+    // the statements which are still running are done before their arguments are released
+    if (pool != NULL) {
+        free_pool(pool);
+    }
+    for (Statement *s; (s = g_queue_pop_head(pending)) != NULL;) {
+        if (status == EXIT_SUCCESS && !finish_statement(s, verdicts, assertions, validations)) {
+            status = EXIT_FAILURE;
         }
+        free_statement(s);
     }
+    g_queue_free(pending);
+    g_ptr_array_free(names, TRUE);
 
-    return EXIT_SUCCESS;
+    return status;
 }
@@ -0,0 +1,138 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include "../include/arena.h"
+#include "../include/bdd.h"
+#include "../include/engine.h"
+#include "../include/pool.h"
+#include "../include/sweep.h"
+
+struct Pool {
+    JobFunc run;
+    GMutex lock;
+    // signaled when a job is submitted, and when a job is done
+    GCond submitted;
+    GCond finished;
+    GQueue *jobs;
+    // the ticket of the next job which is taken, and whether each job is done
+    int next;
+    GArray *done;
+    bool closing;
+    int n_threads;
+    GThread **threads;
+    // the arena of the creator, and those of the threads
+    Arena *arena;
+    Arena **arenas;
+};
+
+typedef struct {
+    Pool *pool;
+    int id;
+} Worker;
+
+static gpointer work(gpointer data) {
+    Worker *w = (Worker *) data;
+    Pool *pool = w->pool;
+    set_arena(pool->arenas[w->id]);
+    set_local_sweep_threads(1);
+
+    g_mutex_lock(&pool->lock);
+    while (true) {
+        while (g_queue_is_empty(pool->jobs) && !pool->closing) {
+            g_cond_wait(&pool->submitted, &pool->lock);
+        }
+        if (g_queue_is_empty(pool->jobs)) {
+            break;
+        }
+        gpointer job = g_queue_pop_head(pool->jobs);
+        int ticket = pool->next++;
+        g_mutex_unlock(&pool->lock);
+
+        pool->run(job);
+
+        g_mutex_lock(&pool->lock);
+        g_array_index(pool->done, gboolean, ticket) = TRUE;
+        g_cond_broadcast(&pool->finished);
+    }
+    g_mutex_unlock(&pool->lock);
+
+    // the pool lasts as long as the script, hence the session and the BDDs of the thread were
+    // reused by all the jobs which it ran
+    end_solver_session();
+    bdd_clear();
+    g_free(w);
+    return NULL;
+}
+
+Pool *create_pool(int n_threads, JobFunc run) {
+    Pool *pool = malloc(sizeof(Pool));
+    pool->run = run;
+    g_mutex_init(&pool->lock);
+    g_cond_init(&pool->submitted);
+    g_cond_init(&pool->finished);
+    pool->jobs = g_queue_new();
+    pool->next = 0;
+    pool->done = g_array_new(FALSE, TRUE, sizeof(gboolean));
+    pool->closing = false;
+    pool->n_threads = n_threads;
+    pool->threads = g_new(GThread *, n_threads);
+    pool->arena = get_arena();
+    pool->arenas = g_new(Arena *, n_threads);
+    for (int i = 0; i < n_threads; i++) {
+        // without an arena, the objects are allocated with malloc
+        pool->arenas[i] = pool->arena != NULL ? create_arena() : NULL;
+        Worker *w = g_new(Worker, 1);
+        w->pool = pool;
+        w->id = i;
+        pool->threads[i] = g_thread_new("pool", work, w);
+    }
+    return pool;
+}
+
+int submit_job(Pool *pool, gpointer job) {
+    g_mutex_lock(&pool->lock);
+    int ticket = (int) pool->done->len;
+    g_array_set_size(pool->done, ticket + 1);
+    g_queue_push_tail(pool->jobs, job);
+    g_cond_signal(&pool->submitted);
+    g_mutex_unlock(&pool->lock);
+    return ticket;
+}
+
+bool job_done(Pool *pool, int ticket) {
+    g_mutex_lock(&pool->lock);
+    bool done = g_array_index(pool->done, gboolean, ticket);
+    g_mutex_unlock(&pool->lock);
+    return done;
+}
+
+void wait_job(Pool *pool, int ticket) {
+    g_mutex_lock(&pool->lock);
+    while (!g_array_index(pool->done, gboolean, ticket)) {
+        g_cond_wait(&pool->finished, &pool->lock);
+    }
+    g_mutex_unlock(&pool->lock);
+}
+
+void free_pool(Pool *pool) {
+    g_mutex_lock(&pool->lock);
+    pool->closing = true;
+    g_cond_broadcast(&pool->submitted);
+    g_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->n_threads; i++) {
+        g_thread_join(pool->threads[i]);
+        if (pool->arenas[i] != NULL) {
+            merge_arena(pool->arena, pool->arenas[i]);
+        }
+    }
+
+    g_free(pool->threads);
+    g_free(pool->arenas);
+    g_array_free(pool->done, TRUE);
+    g_queue_free(pool->jobs);
+    g_cond_clear(&pool->submitted);
+    g_cond_clear(&pool->finished);
+    g_mutex_clear(&pool->lock);
+    free(pool);
+}
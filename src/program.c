@@ -0,0 +1,117 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include "../include/program.h"
+
+Program *create_program() {
+    Program *p = malloc(sizeof(Program));
+    p->capacity = 16;
+    p->code = malloc(p->capacity * sizeof(Instruction));
+    p->length = 0;
+    p->depth = 0;
+    p->max_depth = 0;
+    p->slots = g_array_new(FALSE, FALSE, sizeof(int));
+    p->atoms = g_array_new(FALSE, FALSE, sizeof(int));
+    return p;
+}
+
+void free_program(Program *program) {
+    free(program->code);
+    g_array_free(program->slots, TRUE);
+    g_array_free(program->atoms, TRUE);
+    free(program);
+}
+
+static void emit(Program *program, OpCode op, int slot) {
+    if (program->length == program->capacity) {
+        program->capacity *= 2;
+        program->code = realloc(program->code, program->capacity * sizeof(Instruction));
+    }
+    program->code[program->length].op = op;
+    program->code[program->length].slot = slot;
+    program->length++;
+
+    // atoms push a lane, binary operators pop two lanes and push one, the negation pops and pushes one
+    if (op == OP_ATOM) {
+        if (++program->depth > program->max_depth) {
+            program->max_depth = program->depth;
+        }
+    } else if (op != OP_NOT) {
+        program->depth--;
+    }
+}
+
+static int atom_slot(Program *program, int atom) {
+    static const int none = -1;
+    while (program->slots->len <= (guint) atom) {
+        g_array_append_val(program->slots, none);
+    }
+    int *slot = &g_array_index(program->slots, int, atom);
+    if (*slot < 0) {
+        *slot = (int) program->atoms->len;
+        g_array_append_val(program->atoms, atom);
+    }
+    return *slot;
+}
+
+void emit_wff(Program *program, Wff *wff) {
+    switch (wff->type) {
+        case WFF_ATOMIC_CONDITION:
+            emit(program, OP_ATOM, atom_slot(program, wff->atom));
+            break;
+        case WFF_CONDITIONAL:
+            emit_wff(program, wff->wff1);
+            emit_wff(program, wff->wff2);
+            emit(program, OP_CONDITIONAL, 0);
+            break;
+        case WFF_CONJUNCTION:
+            emit_wff(program, wff->wff1);
+            emit_wff(program, wff->wff2);
+            emit(program, OP_AND, 0);
+            break;
+        case WFF_DISJUNCTION:
+            emit_wff(program, wff->wff1);
+            emit_wff(program, wff->wff2);
+            emit(program, OP_OR, 0);
+            break;
+        case WFF_NEGATION:
+            emit_wff(program, wff->wff1);
+            emit(program, OP_NOT, 0);
+            break;
+        default:
+            // arguments and conditions are never lowered
+            break;
+    }
+}
+
+void emit_operator(Program *program, OpCode op) {
+    emit(program, op, 0);
+}
+
+uint64_t run_program(const Program *program, const uint64_t *columns, uint64_t *stack) {
+    size_t top = 0;
+    for (const Instruction *i = program->code, *end = program->code + program->length; i != end; i++) {
+        switch (i->op) {
+            case OP_ATOM:
+                stack[top++] = columns[i->slot];
+                break;
+            case OP_AND:
+                top--;
+                stack[top - 1] &= stack[top];
+                break;
+            case OP_CONDITIONAL:
+                top--;
+                stack[top - 1] = ~stack[top - 1] | stack[top];
+                break;
+            case OP_NOT:
+                stack[top - 1] = ~stack[top - 1];
+                break;
+            case OP_OR:
+                top--;
+                stack[top - 1] |= stack[top];
+                break;
+        }
+    }
+    return stack[0];
+}
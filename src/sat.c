@@ -0,0 +1,610 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <stdint.h>
+#include "../include/sat.h"
+
+// internally, the variable v (from 0) has the literals 2v and 2v + 1, the latter being the negation
+#define LIT_VAR(l) ((l) >> 1)
+#define LIT_NEG(l) ((l) ^ 1)
+
+#define VALUE_UNDEF (-1)
+
+#define VAR_DECAY 0.95
+#define CLAUSE_DECAY 0.999
+#define RESTART_UNIT 100
+
+typedef struct {
+    int size;
+    bool learnt;
+    double activity;
+    int lits[];
+} Clause;
+
+typedef struct {
+    Clause **data;
+    int size;
+    int capacity;
+} Watches;
+
+struct Solver {
+    int n_vars;
+    int capacity;
+    signed char *assigns;
+    signed char *polarity;
+    signed char *model;
+    char *seen;
+    int *level;
+    Clause **reason;
+    double *activity;
+    Watches *watches;
+
+    // the binary heap of the variables ordered by activity
+    int *heap;
+    int heap_size;
+    int *heap_index;
+
+    int *trail;
+    int trail_size;
+    int *trail_lim;
+    int levels_capacity;
+    int n_levels;
+    int qhead;
+
+    // the literals assumed by the current solve, which are the first decisions
+    GArray *assumptions;
+
+    GPtrArray *clauses;
+    GPtrArray *learnts;
+    double var_inc;
+    double clause_inc;
+    double max_learnts;
+    bool ok;
+};
+
+static int lit_from_dimacs(int lit) {
+    return lit > 0 ? 2 * (lit - 1) : 2 * (-lit - 1) + 1;
+}
+
+static int lit_value(const Solver *s, int lit) {
+    int a = s->assigns[LIT_VAR(lit)];
+    return a == VALUE_UNDEF ? VALUE_UNDEF : a ^ (lit & 1);
+}
+
+// heap
+
+static bool heap_less(const Solver *s, int a, int b) {
+    return s->activity[a] > s->activity[b];
+}
+
+static void heap_up(Solver *s, int i) {
+    int v = s->heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!heap_less(s, v, s->heap[parent])) break;
+        s->heap[i] = s->heap[parent];
+        s->heap_index[s->heap[i]] = i;
+        i = parent;
+    }
+    s->heap[i] = v;
+    s->heap_index[v] = i;
+}
+
+static void heap_down(Solver *s, int i) {
+    int v = s->heap[i];
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= s->heap_size) break;
+        if (child + 1 < s->heap_size && heap_less(s, s->heap[child + 1], s->heap[child])) {
+            child++;
+        }
+        if (!heap_less(s, s->heap[child], v)) break;
+        s->heap[i] = s->heap[child];
+        s->heap_index[s->heap[i]] = i;
+        i = child;
+    }
+    s->heap[i] = v;
+    s->heap_index[v] = i;
+}
+
+static void heap_insert(Solver *s, int v) {
+    if (s->heap_index[v] >= 0) return;
+    s->heap[s->heap_size] = v;
+    s->heap_index[v] = s->heap_size;
+    heap_up(s, s->heap_size++);
+}
+
+static int heap_pop(Solver *s) {
+    int v = s->heap[0];
+    s->heap_index[v] = -1;
+    if (--s->heap_size > 0) {
+        s->heap[0] = s->heap[s->heap_size];
+        s->heap_index[s->heap[0]] = 0;
+        heap_down(s, 0);
+    }
+    return v;
+}
+
+// allocate
+
+Solver *create_solver() {
+    Solver *s = calloc(1, sizeof(Solver));
+    s->clauses = g_ptr_array_new();
+    s->learnts = g_ptr_array_new();
+    s->assumptions = g_array_new(FALSE, FALSE, sizeof(int));
+    s->var_inc = 1;
+    s->clause_inc = 1;
+    s->ok = true;
+    return s;
+}
+
+static void free_watches(Solver *s) {
+    for (int i = 0; i < 2 * s->n_vars; i++) {
+        free(s->watches[i].data);
+    }
+}
+
+void free_solver(Solver *s) {
+    for (guint i = 0; i < s->clauses->len; i++) free(g_ptr_array_index(s->clauses, i));
+    for (guint i = 0; i < s->learnts->len; i++) free(g_ptr_array_index(s->learnts, i));
+    g_ptr_array_free(s->clauses, TRUE);
+    g_ptr_array_free(s->learnts, TRUE);
+    g_array_free(s->assumptions, TRUE);
+    free_watches(s);
+    free(s->watches);
+    free(s->assigns);
+    free(s->polarity);
+    free(s->model);
+    free(s->seen);
+    free(s->level);
+    free(s->reason);
+    free(s->activity);
+    free(s->heap);
+    free(s->heap_index);
+    free(s->trail);
+    free(s->trail_lim);
+    free(s);
+}
+
+// every level has a decision, or an assumption which already holds
+static void reserve_levels(Solver *s, int n) {
+    if (n > s->levels_capacity) {
+        s->levels_capacity = n;
+        s->trail_lim = realloc(s->trail_lim, n * sizeof(int));
+    }
+}
+
+int solver_new_var(Solver *s) {
+    if (s->n_vars == s->capacity) {
+        int c = s->capacity == 0 ? 64 : 2 * s->capacity;
+        s->assigns = realloc(s->assigns, c * sizeof(signed char));
+        s->polarity = realloc(s->polarity, c * sizeof(signed char));
+        s->model = realloc(s->model, c * sizeof(signed char));
+        s->seen = realloc(s->seen, c * sizeof(char));
+        s->level = realloc(s->level, c * sizeof(int));
+        s->reason = realloc(s->reason, c * sizeof(Clause *));
+        s->activity = realloc(s->activity, c * sizeof(double));
+        s->heap = realloc(s->heap, c * sizeof(int));
+        s->heap_index = realloc(s->heap_index, c * sizeof(int));
+        s->trail = realloc(s->trail, c * sizeof(int));
+        reserve_levels(s, c);
+        s->watches = realloc(s->watches, 2 * c * sizeof(Watches));
+        s->capacity = c;
+    }
+    int v = s->n_vars++;
+    s->assigns[v] = VALUE_UNDEF;
+    s->polarity[v] = 0;
+    s->model[v] = VALUE_UNDEF;
+    s->seen[v] = 0;
+    s->level[v] = 0;
+    s->reason[v] = NULL;
+    s->activity[v] = 0;
+    s->heap_index[v] = -1;
+    memset(&s->watches[2 * v], 0, 2 * sizeof(Watches));
+    heap_insert(s, v);
+    return v + 1;
+}
+
+int solver_n_vars(const Solver *s) {
+    return s->n_vars;
+}
+
+// assignment
+
+static void watch(Solver *s, int lit, Clause *c) {
+    Watches *w = &s->watches[lit];
+    if (w->size == w->capacity) {
+        w->capacity = w->capacity == 0 ? 4 : 2 * w->capacity;
+        w->data = realloc(w->data, w->capacity * sizeof(Clause *));
+    }
+    w->data[w->size++] = c;
+}
+
+static void unwatch(Solver *s, int lit, const Clause *c) {
+    Watches *w = &s->watches[lit];
+    for (int i = 0; i < w->size; i++) {
+        if (w->data[i] == c) {
+            w->data[i] = w->data[--w->size];
+            return;
+        }
+    }
+}
+
+static void enqueue(Solver *s, int lit, Clause *reason) {
+    int v = LIT_VAR(lit);
+    s->assigns[v] = (signed char) !(lit & 1);
+    s->level[v] = s->n_levels;
+    s->reason[v] = reason;
+    s->trail[s->trail_size++] = lit;
+}
+
+static void cancel_until(Solver *s, int level) {
+    if (s->n_levels <= level) return;
+    for (int i = s->trail_size - 1; i >= s->trail_lim[level]; i--) {
+        int v = LIT_VAR(s->trail[i]);
+        s->polarity[v] = s->assigns[v];
+        s->assigns[v] = VALUE_UNDEF;
+        s->reason[v] = NULL;
+        heap_insert(s, v);
+    }
+    s->trail_size = s->trail_lim[level];
+    s->qhead = s->trail_size;
+    s->n_levels = level;
+}
+
+// returns the conflicting clause, if any
+static Clause *propagate(Solver *s) {
+    while (s->qhead < s->trail_size) {
+        int false_lit = LIT_NEG(s->trail[s->qhead++]);
+        Watches *ws = &s->watches[false_lit];
+        int i = 0, j = 0;
+        while (i < ws->size) {
+            Clause *c = ws->data[i++];
+            // the false literal is moved to the second position
+            if (c->lits[0] == false_lit) {
+                c->lits[0] = c->lits[1];
+                c->lits[1] = false_lit;
+            }
+            if (lit_value(s, c->lits[0]) == 1) {
+                ws->data[j++] = c;
+                continue;
+            }
+            bool moved = false;
+            for (int k = 2; k < c->size; k++) {
+                if (lit_value(s, c->lits[k]) != 0) {
+                    c->lits[1] = c->lits[k];
+                    c->lits[k] = false_lit;
+                    watch(s, c->lits[1], c);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            ws->data[j++] = c;
+            if (lit_value(s, c->lits[0]) == 0) {
+                while (i < ws->size) {
+                    ws->data[j++] = ws->data[i++];
+                }
+                ws->size = j;
+                s->qhead = s->trail_size;
+                return c;
+            }
+            enqueue(s, c->lits[0], c);
+        }
+        ws->size = j;
+    }
+    return NULL;
+}
+
+// activities
+
+static void bump_var(Solver *s, int v) {
+    if ((s->activity[v] += s->var_inc) > 1e100) {
+        for (int i = 0; i < s->n_vars; i++) {
+            s->activity[i] *= 1e-100;
+        }
+        s->var_inc *= 1e-100;
+    }
+    if (s->heap_index[v] >= 0) {
+        heap_up(s, s->heap_index[v]);
+    }
+}
+
+static void bump_clause(Solver *s, Clause *c) {
+    if ((c->activity += s->clause_inc) > 1e20) {
+        for (guint i = 0; i < s->learnts->len; i++) {
+            ((Clause *) g_ptr_array_index(s->learnts, i))->activity *= 1e-20;
+        }
+        s->clause_inc *= 1e-20;
+    }
+}
+
+// learning
+
+// computes the first-UIP clause of a conflict into learnt, whose first literal is the asserting one,
+// and returns the level to backjump to
+static int analyze(Solver *s, Clause *conflict, GArray *learnt) {
+    g_array_set_size(learnt, 1);
+    int paths = 0;
+    int p = -1;
+    int index = s->trail_size - 1;
+    Clause *c = conflict;
+
+    do {
+        if (c->learnt) {
+            bump_clause(s, c);
+        }
+        for (int k = p == -1 ? 0 : 1; k < c->size; k++) {
+            int q = c->lits[k];
+            int v = LIT_VAR(q);
+            if (!s->seen[v] && s->level[v] > 0) {
+                bump_var(s, v);
+                s->seen[v] = 1;
+                if (s->level[v] >= s->n_levels) {
+                    paths++;
+                } else {
+                    g_array_append_val(learnt, q);
+                }
+            }
+        }
+        while (!s->seen[LIT_VAR(s->trail[index--])]);
+        p = s->trail[index + 1];
+        c = s->reason[LIT_VAR(p)];
+        s->seen[LIT_VAR(p)] = 0;
+        paths--;
+    } while (paths > 0);
+    g_array_index(learnt, int, 0) = LIT_NEG(p);
+
+    // a literal implied by other literals of the clause is redundant: the kept literals are swapped
+    // to the front, and the redundant ones stay behind them, since their marks are still cleared
+    guint n = 1;
+    for (guint i = 1; i < learnt->len; i++) {
+        int q = g_array_index(learnt, int, i);
+        Clause *r = s->reason[LIT_VAR(q)];
+        bool redundant = r != NULL;
+        for (int k = 1; redundant && k < r->size; k++) {
+            int u = LIT_VAR(r->lits[k]);
+            redundant = s->seen[u] || s->level[u] == 0;
+        }
+        if (!redundant) {
+            g_array_index(learnt, int, i) = g_array_index(learnt, int, n);
+            g_array_index(learnt, int, n++) = q;
+        }
+    }
+    for (guint i = 1; i < learnt->len; i++) {
+        s->seen[LIT_VAR(g_array_index(learnt, int, i))] = 0;
+    }
+    g_array_set_size(learnt, n);
+
+    // the literal of the highest level goes in the second position, to be watched
+    int level = 0;
+    if (n > 1) {
+        guint max = 1;
+        for (guint i = 2; i < n; i++) {
+            if (s->level[LIT_VAR(g_array_index(learnt, int, i))] >
+                s->level[LIT_VAR(g_array_index(learnt, int, max))]) {
+                max = i;
+            }
+        }
+        int q = g_array_index(learnt, int, max);
+        g_array_index(learnt, int, max) = g_array_index(learnt, int, 1);
+        g_array_index(learnt, int, 1) = q;
+        level = s->level[LIT_VAR(q)];
+    }
+    return level;
+}
+
+static Clause *new_clause(const int *lits, int n, bool learnt) {
+    Clause *c = malloc(sizeof(Clause) + n * sizeof(int));
+    c->size = n;
+    c->learnt = learnt;
+    c->activity = 0;
+    memcpy(c->lits, lits, n * sizeof(int));
+    return c;
+}
+
+static bool locked(const Solver *s, const Clause *c) {
+    return s->reason[LIT_VAR(c->lits[0])] == c && lit_value(s, c->lits[0]) == 1;
+}
+
+static int compare_activity(gconstpointer a, gconstpointer b) {
+    double x = (*(Clause **) a)->activity;
+    double y = (*(Clause **) b)->activity;
+    return x < y ? -1 : x > y;
+}
+
+// removes the less active half of the learnt clauses which are not reasons of an assignment
+static void reduce_learnts(Solver *s) {
+    g_ptr_array_sort(s->learnts, compare_activity);
+    guint half = s->learnts->len / 2;
+    guint j = 0;
+    for (guint i = 0; i < s->learnts->len; i++) {
+        Clause *c = g_ptr_array_index(s->learnts, i);
+        if (i < half && c->size > 2 && !locked(s, c)) {
+            unwatch(s, c->lits[0], c);
+            unwatch(s, c->lits[1], c);
+            free(c);
+        } else {
+            g_ptr_array_index(s->learnts, j++) = c;
+        }
+    }
+    g_ptr_array_set_size(s->learnts, (gint) j);
+}
+
+// search
+
+bool solver_add_clause(Solver *s, const int *literals, size_t n) {
+    if (!s->ok) return false;
+    cancel_until(s, 0);
+
+    int *lits = malloc((n > 0 ? n : 1) * sizeof(int));
+    int size = 0;
+    for (size_t i = 0; i < n; i++) {
+        int lit = lit_from_dimacs(literals[i]);
+        int value = lit_value(s, lit);
+        if (value == 1) {
+            free(lits);
+            return true;
+        }
+        if (value == 0) continue;
+
+        bool duplicate = false;
+        for (int k = 0; k < size; k++) {
+            if (lits[k] == LIT_NEG(lit)) {
+                // a tautological clause
+                free(lits);
+                return true;
+            }
+            duplicate = duplicate || lits[k] == lit;
+        }
+        if (!duplicate) {
+            lits[size++] = lit;
+        }
+    }
+
+    if (size == 0) {
+        s->ok = false;
+    } else if (size == 1) {
+        enqueue(s, lits[0], NULL);
+        s->ok = propagate(s) == NULL;
+    } else {
+        Clause *c = new_clause(lits, size, false);
+        g_ptr_array_add(s->clauses, c);
+        watch(s, c->lits[0], c);
+        watch(s, c->lits[1], c);
+    }
+    free(lits);
+    return s->ok;
+}
+
+typedef enum {
+    SEARCH_SATISFIABLE,
+    SEARCH_UNSATISFIABLE,
+    // the clauses are unsatisfiable under the assumptions
+    SEARCH_FAILED,
+    SEARCH_RESTART
+} SearchResult;
+
+static SearchResult search(Solver *s, long max_conflicts, GArray *learnt) {
+    long conflicts = 0;
+    for (;;) {
+        Clause *conflict = propagate(s);
+        if (conflict != NULL) {
+            conflicts++;
+            if (s->n_levels == 0) {
+                return SEARCH_UNSATISFIABLE;
+            }
+            int level = analyze(s, conflict, learnt);
+            cancel_until(s, level);
+            int *lits = (int *) learnt->data;
+            if (learnt->len == 1) {
+                enqueue(s, lits[0], NULL);
+            } else {
+                Clause *c = new_clause(lits, (int) learnt->len, true);
+                g_ptr_array_add(s->learnts, c);
+                watch(s, c->lits[0], c);
+                watch(s, c->lits[1], c);
+                bump_clause(s, c);
+                enqueue(s, lits[0], c);
+            }
+            s->var_inc /= VAR_DECAY;
+            s->clause_inc /= CLAUSE_DECAY;
+        } else {
+            if (conflicts >= max_conflicts) {
+                cancel_until(s, 0);
+                return SEARCH_RESTART;
+            }
+            if ((double) s->learnts->len - s->trail_size >= s->max_learnts) {
+                reduce_learnts(s);
+            }
+
+            // the assumptions are decided first, one per level
+            int next = -1;
+            while (next == -1 && s->n_levels < (int) s->assumptions->len) {
+                int p = g_array_index(s->assumptions, int, s->n_levels);
+                int value = lit_value(s, p);
+                if (value == 1) {
+                    s->trail_lim[s->n_levels++] = s->trail_size;
+                } else if (value == 0) {
+                    return SEARCH_FAILED;
+                } else {
+                    next = p;
+                }
+            }
+            while (next == -1 && s->heap_size > 0) {
+                int v = heap_pop(s);
+                if (s->assigns[v] == VALUE_UNDEF) {
+                    next = 2 * v + !s->polarity[v];
+                }
+            }
+            if (next == -1) {
+                return SEARCH_SATISFIABLE;
+            }
+            s->trail_lim[s->n_levels++] = s->trail_size;
+            enqueue(s, next, NULL);
+        }
+    }
+}
+
+// the i-th element (from 0) of the Luby sequence 1, 1, 2, 1, 1, 2, 4, ...
+static long luby(long i) {
+    long size = 1;
+    int seq = 0;
+    while (size < i + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != i) {
+        size = (size - 1) >> 1;
+        seq--;
+        i = i % size;
+    }
+    return 1L << seq;
+}
+
+bool solver_solve(Solver *s) {
+    return solver_solve_assuming(s, NULL, 0);
+}
+
+bool solver_solve_assuming(Solver *s, const int *assumptions, size_t n) {
+    if (!s->ok) return false;
+    cancel_until(s, 0);
+    if (propagate(s) != NULL) {
+        s->ok = false;
+        return false;
+    }
+
+    g_array_set_size(s->assumptions, 0);
+    for (size_t i = 0; i < n; i++) {
+        int lit = lit_from_dimacs(assumptions[i]);
+        g_array_append_val(s->assumptions, lit);
+    }
+    reserve_levels(s, s->n_vars + (int) n);
+
+    if (s->max_learnts < s->clauses->len / 3.0) {
+        s->max_learnts = s->clauses->len / 3.0 + 100;
+    }
+
+    GArray *learnt = g_array_new(FALSE, FALSE, sizeof(int));
+    SearchResult result = SEARCH_RESTART;
+    for (long restarts = 0; result == SEARCH_RESTART; restarts++) {
+        result = search(s, luby(restarts) * RESTART_UNIT, learnt);
+        s->max_learnts *= 1.05;
+    }
+    g_array_free(learnt, TRUE);
+
+    // the learnt clauses follow from the clauses alone, and stay valid for the next solves
+    if (result == SEARCH_SATISFIABLE) {
+        memcpy(s->model, s->assigns, s->n_vars * sizeof(signed char));
+    } else if (result == SEARCH_UNSATISFIABLE) {
+        s->ok = false;
+    }
+    cancel_until(s, 0);
+    return result == SEARCH_SATISFIABLE;
+}
+
+bool solver_model_value(const Solver *s, int var) {
+    return s->model[var - 1] == 1;
+}
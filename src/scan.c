@@ -0,0 +1,249 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <stdint.h>
+#include "../include/cpu.h"
+#include "../include/scan.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+typedef size_t (*LineFunc)(const char *text, size_t length, size_t *comment);
+
+typedef size_t (*RunFunc)(Run run, const char *text, size_t i, size_t end);
+
+// the runs of every byte, as bits
+#define IN(run) (1u << (run))
+
+// the ranges are disjoint, and every byte but the quote is in the strings
+#define STRING IN(RUN_STRING)
+
+static const uint8_t members[256] = {
+        [0 ... '\t' - 1] = STRING,
+        ['\t'] = IN(RUN_SPACES) | STRING,
+        ['\t' + 1 ... ' ' - 1] = STRING,
+        [' '] = IN(RUN_SPACES) | STRING,
+        ['!'] = STRING,
+        ['"'] = 0,
+        ['#' ... '&'] = STRING,
+        ['\''] = IN(RUN_ATOM) | STRING,
+        ['(' ... '/'] = STRING,
+        ['0' ... '9'] = IN(RUN_ATOM) | IN(RUN_WORD) | STRING,
+        [':' ... '@'] = STRING,
+        ['A' ... 'Z'] = IN(RUN_ATOM) | STRING,
+        ['[' ... '^'] = STRING,
+        ['_'] = IN(RUN_ATOM) | IN(RUN_WORD) | STRING,
+        ['`'] = STRING,
+        ['a' ... 'z'] = IN(RUN_WORD) | STRING,
+        ['{' ... 255] = STRING
+};
+
+// the same runs as ranges of bytes, for the vector kernels
+typedef struct {
+    int n;
+    uint8_t low[4];
+    uint8_t high[4];
+} Ranges;
+
+static const Ranges ranges[N_RUNS] = {
+        [RUN_SPACES] = {2, {' ', '\t'}, {' ', '\t'}},
+        [RUN_ATOM] = {4, {'A', '0', '_', '\''}, {'Z', '9', '_', '\''}},
+        [RUN_WORD] = {3, {'a', '0', '_'}, {'z', '9', '_'}},
+        [RUN_STRING] = {2, {0x00, '"' + 1}, {'"' - 1, 0xFF}}
+};
+
+static size_t line_scalar(const char *text, size_t length, size_t *comment) {
+    *comment = SIZE_MAX;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '\n') {
+            if (*comment == SIZE_MAX) {
+                *comment = i + 1;
+            }
+            return i + 1;
+        }
+        if (text[i] == '/' && *comment == SIZE_MAX && i + 1 < length && text[i + 1] == '/') {
+            *comment = i;
+        }
+    }
+    if (*comment == SIZE_MAX) {
+        *comment = length;
+    }
+    return length;
+}
+
+static size_t run_scalar(Run run, const char *text, size_t i, size_t end) {
+    while (i < end && members[(uint8_t) text[i]] & IN(run)) {
+        i++;
+    }
+    return i;
+}
+
+#if defined(__x86_64__)
+
+// The vector kernels look for the newlines and the slashes of a line a vector at a time, and
+// leave the last bytes, which do not fill a vector, to the scalar kernel. A slash is the start of
+// a comment only if the next byte, which may be in the next vector, is a slash too
+
+__attribute__((target("sse4.2")))
+static size_t line_sse42(const char *text, size_t length, size_t *comment) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i slash = _mm_set1_epi8('/');
+    size_t found = SIZE_MAX;
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (text + i));
+        unsigned newlines = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        unsigned slashes = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, slash));
+        // only the slashes before the first newline belong to the line
+        if (newlines != 0) {
+            slashes &= (newlines & -newlines) - 1;
+        }
+        for (; slashes != 0 && found == SIZE_MAX; slashes &= slashes - 1) {
+            size_t at = i + __builtin_ctz(slashes);
+            if (at + 1 < length && text[at + 1] == '/') {
+                found = at;
+            }
+        }
+        if (newlines != 0) {
+            size_t n = i + __builtin_ctz(newlines) + 1;
+            *comment = found != SIZE_MAX ? found : n;
+            return n;
+        }
+    }
+    size_t rest;
+    size_t n = i + line_scalar(text + i, length - i, &rest);
+    *comment = found != SIZE_MAX ? found : i + rest;
+    return n;
+}
+
+// the first byte which is not in the ranges of the run, by an explicit-length string compare
+__attribute__((target("sse4.2")))
+static size_t run_sse42(Run run, const char *text, size_t i, size_t end) {
+    const Ranges *r = &ranges[run];
+    uint8_t bounds[16] = {0};
+    for (int k = 0; k < r->n; k++) {
+        bounds[2 * k] = r->low[k];
+        bounds[2 * k + 1] = r->high[k];
+    }
+    const __m128i set = _mm_loadu_si128((const __m128i *) bounds);
+    for (; i + 16 <= end; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *) (text + i));
+        int at = _mm_cmpestri(set, 2 * r->n, chunk, 16,
+                              _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+        if (at < 16) {
+            return i + at;
+        }
+    }
+    return run_scalar(run, text, i, end);
+}
+
+__attribute__((target("avx2")))
+static size_t line_avx2(const char *text, size_t length, size_t *comment) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i slash = _mm256_set1_epi8('/');
+    size_t found = SIZE_MAX;
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) (text + i));
+        uint32_t newlines = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline));
+        uint32_t slashes = (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, slash));
+        if (newlines != 0) {
+            slashes &= (newlines & -newlines) - 1;
+        }
+        for (; slashes != 0 && found == SIZE_MAX; slashes &= slashes - 1) {
+            size_t at = i + __builtin_ctz(slashes);
+            if (at + 1 < length && text[at + 1] == '/') {
+                found = at;
+            }
+        }
+        if (newlines != 0) {
+            size_t n = i + __builtin_ctz(newlines) + 1;
+            *comment = found != SIZE_MAX ? found : n;
+            return n;
+        }
+    }
+    size_t rest;
+    size_t n = i + line_scalar(text + i, length - i, &rest);
+    *comment = found != SIZE_MAX ? found : i + rest;
+    return n;
+}
+
+// a byte x is in the range [low, high] if x - low, as an unsigned byte, is at most high - low
+__attribute__((target("avx2")))
+static size_t run_avx2(Run run, const char *text, size_t i, size_t end) {
+    const Ranges *r = &ranges[run];
+    __m256i low[4];
+    __m256i width[4];
+    for (int k = 0; k < r->n; k++) {
+        low[k] = _mm256_set1_epi8((char) r->low[k]);
+        width[k] = _mm256_set1_epi8((char) (r->high[k] - r->low[k]));
+    }
+    for (; i + 32 <= end; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) (text + i));
+        __m256i in = _mm256_setzero_si256();
+        for (int k = 0; k < r->n; k++) {
+            __m256i offset = _mm256_sub_epi8(chunk, low[k]);
+            in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_min_epu8(offset, width[k]), offset));
+        }
+        uint32_t out = ~(uint32_t) _mm256_movemask_epi8(in);
+        if (out != 0) {
+            return i + __builtin_ctz(out);
+        }
+    }
+    return run_scalar(run, text, i, end);
+}
+
+#endif
+
+static ScanKernel selected = SCAN_SCALAR;
+static LineFunc line_kernel = line_scalar;
+static RunFunc run_kernel = run_scalar;
+static bool chosen = false;
+
+void init_scan() {
+    if (!set_scan_kernel(SCAN_AVX2) && !set_scan_kernel(SCAN_SSE42)) {
+        set_scan_kernel(SCAN_SCALAR);
+    }
+}
+
+bool set_scan_kernel(ScanKernel k) {
+    switch (k) {
+#if defined(__x86_64__)
+        case SCAN_AVX2:
+            if (!cpu_supports_avx2()) return false;
+            line_kernel = line_avx2;
+            run_kernel = run_avx2;
+            break;
+        case SCAN_SSE42:
+            if (!cpu_supports_sse42()) return false;
+            line_kernel = line_sse42;
+            run_kernel = run_sse42;
+            break;
+#endif
+        case SCAN_SCALAR:
+            line_kernel = line_scalar;
+            run_kernel = run_scalar;
+            break;
+        default:
+            return false;
+    }
+    selected = k;
+    chosen = true;
+    return true;
+}
+
+ScanKernel get_scan_kernel() {
+    if (!chosen) {
+        init_scan();
+    }
+    return selected;
+}
+
+size_t scan_line(const char *text, size_t length, size_t *comment) {
+    return line_kernel(text, length, comment);
+}
+
+size_t skip_run(Run run, const char *text, size_t i, size_t end) {
+    return run_kernel(run, text, i, end);
+}
@@ -0,0 +1,114 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include "../include/simplify.h"
+#include "../include/unique.h"
+
+// the maximum number of rewritings of a whole wff, each of which reaches a fixpoint on its nodes
+#define MAX_PASSES 8
+
+// the constants, which only exist while a wff is rewritten
+static Wff constant_true = {.type = WFF_ATOMIC_CONDITION, .atom = -1, .id = -1};
+static Wff constant_false = {.type = WFF_ATOMIC_CONDITION, .atom = -1, .id = -1};
+
+// the rewritten wffs, by node, of the wffs and of their negations
+typedef struct {
+    GHashTable *memo[2];
+} Rewriter;
+
+static bool same(const Wff *a, const Wff *b) {
+    return a == b || (a->id >= 0 && a->id == b->id);
+}
+
+// true if a is one of the operands of b, whose type is given
+static bool operand_of(const Wff *a, const Wff *b, WffType type) {
+    return b->type == type && (same(a, b->wff1) || same(a, b->wff2));
+}
+
+static Wff *rewrite(Rewriter *r, Wff *wff, bool negated);
+
+// the conjunction, or disjunction, of the rewritings of x and y
+static Wff *combine(Rewriter *r, WffType type, Wff *x, bool x_negated, Wff *y, bool y_negated) {
+    bool conjunction = type == WFF_CONJUNCTION;
+    Wff *zero = conjunction ? &constant_false : &constant_true;
+    Wff *one = conjunction ? &constant_true : &constant_false;
+    WffType dual = conjunction ? WFF_DISJUNCTION : WFF_CONJUNCTION;
+
+    Wff *a = rewrite(r, x, x_negated);
+    if (a == zero) return zero;
+    Wff *b = rewrite(r, y, y_negated);
+    if (b == zero) return zero;
+    if (a == one) return b;
+    if (b == one) return a;
+
+    // idempotence, and absorption
+    if (same(a, b) || operand_of(a, b, dual)) return a;
+    if (operand_of(b, a, dual)) return b;
+
+    // complementation, also of an operand of an operand of the same type
+    Wff *not_a = rewrite(r, x, !x_negated);
+    Wff *not_b = rewrite(r, y, !y_negated);
+    if (same(b, not_a) || operand_of(not_a, b, type) || operand_of(not_b, a, type)) return zero;
+
+    return unique_binary(type, a, b);
+}
+
+static Wff *rewrite(Rewriter *r, Wff *wff, bool negated) {
+    if (wff->type == WFF_NEGATION) {
+        return rewrite(r, wff->wff1, !negated);
+    }
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        Wff *atom = unique_atomic_condition(wff->atom);
+        return negated ? unique_negation(atom) : atom;
+    }
+
+    Wff *known = g_hash_table_lookup(r->memo[negated], wff);
+    if (known != NULL) {
+        return known;
+    }
+
+    Wff *result;
+    if (wff->type == WFF_CONJUNCTION) {
+        result = combine(r, negated ? WFF_DISJUNCTION : WFF_CONJUNCTION, wff->wff1, negated, wff->wff2, negated);
+    } else if (wff->type == WFF_DISJUNCTION) {
+        result = combine(r, negated ? WFF_CONJUNCTION : WFF_DISJUNCTION, wff->wff1, negated, wff->wff2, negated);
+    } else {
+        // P -> Q is !P | Q, and its negation is P & !Q
+        result = combine(r, negated ? WFF_CONJUNCTION : WFF_DISJUNCTION, wff->wff1, !negated, wff->wff2, negated);
+    }
+    g_hash_table_insert(r->memo[negated], wff, result);
+    return result;
+}
+
+Wff *simplify_wff(Wff *wff, bool *value) {
+    Rewriter r;
+    for (int pass = 0; pass < MAX_PASSES; pass++) {
+        r.memo[0] = g_hash_table_new(g_direct_hash, g_direct_equal);
+        r.memo[1] = g_hash_table_new(g_direct_hash, g_direct_equal);
+        Wff *result = rewrite(&r, wff, false);
+        g_hash_table_destroy(r.memo[0]);
+        g_hash_table_destroy(r.memo[1]);
+
+        if (result == &constant_true || result == &constant_false) {
+            *value = result == &constant_true;
+            return NULL;
+        }
+        if (result == wff) {
+            break;
+        }
+        wff = result;
+    }
+    return wff;
+}
+
+size_t wff_size(const Wff *wff) {
+    switch (wff->type) {
+        case WFF_ATOMIC_CONDITION:
+            return 1;
+        case WFF_NEGATION:
+            return 1 + wff_size(wff->wff1);
+        default:
+            return 1 + wff_size(wff->wff1) + wff_size(wff->wff2);
+    }
+}
@@ -0,0 +1,339 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <stdatomic.h>
+#include "../include/cpu.h"
+#include "../include/jit.h"
+#include "../include/sweep.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// the columns of the first six atoms are the same in every block of 64 rows
+static const uint64_t lane_masks[] = {
+        0xAAAAAAAAAAAAAAAAULL,
+        0xCCCCCCCCCCCCCCCCULL,
+        0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL,
+        0xFFFF0000FFFF0000ULL,
+        0xFFFFFFFF00000000ULL
+};
+
+#define LANE_ATOMS 6
+
+// the number of blocks claimed at once by a thread of a sweep
+#define CHUNK_BLOCKS 4096
+
+// the number of blocks from which the scalar kernel runs the program as machine code
+#define JIT_BLOCKS 16
+
+// The blocks are visited in Gray-code order: the step i visits the block gray(i), which differs
+// from the previous one in a single atom, so that a kernel can update one column per step
+static inline uint64_t gray(uint64_t step) {
+    return step ^ (step >> 1);
+}
+
+// a kernel sweeps the steps in [first, last) and stores the first row which makes the program true;
+// jit is the machine code of the program, or NULL
+typedef bool (*KernelFunc)(const Program *program, const Jit *jit, uint64_t first, uint64_t last, uint64_t *row);
+
+static bool sweep_scalar(const Program *program, const Jit *jit, uint64_t first, uint64_t last, uint64_t *row) {
+    size_t n = program->atoms->len;
+
+    uint64_t *columns = malloc((n > 0 ? n : 1) * sizeof(uint64_t));
+    uint64_t *stack = malloc((program->max_depth > 0 ? program->max_depth : 1) * sizeof(uint64_t));
+    for (size_t j = 0; j < n && j < LANE_ATOMS; j++) {
+        columns[j] = lane_masks[j];
+    }
+
+    // the remaining atoms are constant within a block, and take the bits of its index
+    uint64_t block = gray(first);
+    for (size_t j = LANE_ATOMS; j < n; j++) {
+        columns[j] = (block >> (j - LANE_ATOMS)) & 1 ? ~0ULL : 0;
+    }
+
+    bool found = false;
+    for (uint64_t step = first; step < last; step++) {
+        if (step != first) {
+            // the next block flips the atom of the lowest set bit of the step
+            columns[LANE_ATOMS + __builtin_ctzll(step)] ^= ~0ULL;
+        }
+        uint64_t lanes = jit != NULL ? run_jit(jit, columns) : run_program(program, columns, stack);
+        if (n < LANE_ATOMS) {
+            lanes &= (1ULL << (1 << n)) - 1;
+        }
+        if (lanes) {
+            *row = (gray(step) << LANE_ATOMS) | __builtin_ctzll(lanes);
+            found = true;
+            break;
+        }
+    }
+
+    free(stack);
+    free(columns);
+    return found;
+}
+
+#if defined(__x86_64__)
+
+// The wide kernels run the program over consecutive steps, one block per 64-bit element. The
+// column of an atom beyond the sixth one is generated in a register from the Gray codes of the
+// steps, and the steps which do not fill a whole vector are left to the scalar kernel
+
+__attribute__((target("avx2")))
+static bool sweep_avx2(const Program *program, const Jit *jit, uint64_t first, uint64_t last, uint64_t *row) {
+    size_t depth = program->max_depth > 0 ? program->max_depth : 1;
+    __m256i *stack = aligned_alloc(sizeof(__m256i), depth * sizeof(__m256i));
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i step = _mm256_set1_epi64x(4);
+    __m256i steps = _mm256_add_epi64(_mm256_set1_epi64x((long long) first), _mm256_setr_epi64x(0, 1, 2, 3));
+
+    bool found = false;
+    uint64_t block = first;
+    for (; !found && last - block >= 4; block += 4, steps = _mm256_add_epi64(steps, step)) {
+        __m256i blocks = _mm256_xor_si256(steps, _mm256_srli_epi64(steps, 1));
+        size_t top = 0;
+        for (const Instruction *i = program->code, *end = program->code + program->length; i != end; i++) {
+            switch (i->op) {
+                case OP_ATOM:
+                    if (i->slot < LANE_ATOMS) {
+                        stack[top++] = _mm256_set1_epi64x((long long) lane_masks[i->slot]);
+                    } else {
+                        __m256i bit = _mm256_srl_epi64(blocks, _mm_cvtsi32_si128(i->slot - LANE_ATOMS));
+                        stack[top++] = _mm256_sub_epi64(zero, _mm256_and_si256(bit, one));
+                    }
+                    break;
+                case OP_AND:
+                    top--;
+                    stack[top - 1] = _mm256_and_si256(stack[top - 1], stack[top]);
+                    break;
+                case OP_CONDITIONAL:
+                    top--;
+                    stack[top - 1] = _mm256_or_si256(_mm256_xor_si256(stack[top - 1], ones), stack[top]);
+                    break;
+                case OP_NOT:
+                    stack[top - 1] = _mm256_xor_si256(stack[top - 1], ones);
+                    break;
+                case OP_OR:
+                    top--;
+                    stack[top - 1] = _mm256_or_si256(stack[top - 1], stack[top]);
+                    break;
+            }
+        }
+        if (!_mm256_testz_si256(stack[0], stack[0])) {
+            uint64_t lanes[4];
+            _mm256_storeu_si256((__m256i *) lanes, stack[0]);
+            for (int k = 0; k < 4; k++) {
+                if (lanes[k]) {
+                    *row = (gray(block + k) << LANE_ATOMS) | __builtin_ctzll(lanes[k]);
+                    break;
+                }
+            }
+            found = true;
+        }
+    }
+
+    free(stack);
+    return found || (block < last && sweep_scalar(program, jit, block, last, row));
+}
+
+__attribute__((target("avx512f")))
+static bool sweep_avx512(const Program *program, const Jit *jit, uint64_t first, uint64_t last, uint64_t *row) {
+    size_t depth = program->max_depth > 0 ? program->max_depth : 1;
+    __m512i *stack = aligned_alloc(sizeof(__m512i), depth * sizeof(__m512i));
+
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i step = _mm512_set1_epi64(8);
+    __m512i steps = _mm512_add_epi64(_mm512_set1_epi64((long long) first),
+                                     _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+
+    bool found = false;
+    uint64_t block = first;
+    for (; !found && last - block >= 8; block += 8, steps = _mm512_add_epi64(steps, step)) {
+        __m512i blocks = _mm512_xor_si512(steps, _mm512_srli_epi64(steps, 1));
+        size_t top = 0;
+        for (const Instruction *i = program->code, *end = program->code + program->length; i != end; i++) {
+            switch (i->op) {
+                case OP_ATOM:
+                    if (i->slot < LANE_ATOMS) {
+                        stack[top++] = _mm512_set1_epi64((long long) lane_masks[i->slot]);
+                    } else {
+                        __m512i bit = _mm512_srl_epi64(blocks, _mm_cvtsi32_si128(i->slot - LANE_ATOMS));
+                        stack[top++] = _mm512_sub_epi64(zero, _mm512_and_si512(bit, one));
+                    }
+                    break;
+                case OP_AND:
+                    top--;
+                    stack[top - 1] = _mm512_and_si512(stack[top - 1], stack[top]);
+                    break;
+                case OP_CONDITIONAL:
+                    // 0xCF is the truth table of !a | b
+                    top--;
+                    stack[top - 1] = _mm512_ternarylogic_epi64(stack[top - 1], stack[top], stack[top], 0xCF);
+                    break;
+                case OP_NOT:
+                    stack[top - 1] = _mm512_ternarylogic_epi64(stack[top - 1], stack[top - 1], stack[top - 1], 0x55);
+                    break;
+                case OP_OR:
+                    top--;
+                    stack[top - 1] = _mm512_or_si512(stack[top - 1], stack[top]);
+                    break;
+            }
+        }
+        __mmask8 hits = _mm512_test_epi64_mask(stack[0], stack[0]);
+        if (hits) {
+            uint64_t lanes[8];
+            _mm512_storeu_si512(lanes, stack[0]);
+            int k = __builtin_ctz(hits);
+            *row = (gray(block + k) << LANE_ATOMS) | __builtin_ctzll(lanes[k]);
+            found = true;
+        }
+    }
+
+    free(stack);
+    return found || (block < last && sweep_scalar(program, jit, block, last, row));
+}
+
+#endif
+
+static SweepKernel selected = SWEEP_SCALAR;
+static KernelFunc kernel = NULL;
+static int threads = 0;
+static _Thread_local int local_threads = 0;
+
+void init_sweep() {
+    if (!set_sweep_kernel(SWEEP_AVX512) && !set_sweep_kernel(SWEEP_AVX2)) {
+        set_sweep_kernel(SWEEP_SCALAR);
+    }
+}
+
+bool set_sweep_kernel(SweepKernel k) {
+    switch (k) {
+#if defined(__x86_64__)
+        case SWEEP_AVX512:
+            if (!cpu_supports_avx512()) return false;
+            kernel = sweep_avx512;
+            break;
+        case SWEEP_AVX2:
+            if (!cpu_supports_avx2()) return false;
+            kernel = sweep_avx2;
+            break;
+#endif
+        case SWEEP_SCALAR:
+            kernel = sweep_scalar;
+            break;
+        default:
+            return false;
+    }
+    selected = k;
+    return true;
+}
+
+SweepKernel get_sweep_kernel() {
+    if (kernel == NULL) {
+        init_sweep();
+    }
+    return selected;
+}
+
+void set_sweep_threads(int n) {
+    threads = n;
+}
+
+void set_local_sweep_threads(int n) {
+    local_threads = n;
+}
+
+int get_sweep_threads() {
+    if (local_threads > 0) {
+        return local_threads;
+    }
+    return threads > 0 ? threads : (int) g_get_num_processors();
+}
+
+// the state shared by the threads of a sweep
+typedef struct {
+    const Program *program;
+    const Jit *jit;
+    uint64_t blocks;
+    atomic_uint_fast64_t next;
+    atomic_bool found;
+    GMutex lock;
+    uint64_t row;
+} Sweep;
+
+static gpointer sweep_worker(gpointer data) {
+    Sweep *sweep = (Sweep *) data;
+    while (!atomic_load(&sweep->found)) {
+        uint64_t first = atomic_fetch_add(&sweep->next, CHUNK_BLOCKS);
+        if (first >= sweep->blocks) {
+            break;
+        }
+        uint64_t last = sweep->blocks - first > CHUNK_BLOCKS ? first + CHUNK_BLOCKS : sweep->blocks;
+        uint64_t row;
+        if (kernel(sweep->program, sweep->jit, first, last, &row)) {
+            // the other threads stop before claiming their next chunk
+            g_mutex_lock(&sweep->lock);
+            if (!atomic_load(&sweep->found) || row < sweep->row) {
+                sweep->row = row;
+            }
+            atomic_store(&sweep->found, true);
+            g_mutex_unlock(&sweep->lock);
+        }
+    }
+    return NULL;
+}
+
+bool sweep_program(const Program *program, uint64_t *row) {
+    if (kernel == NULL) {
+        init_sweep();
+    }
+
+    size_t n = program->atoms->len;
+    uint64_t blocks = n > LANE_ATOMS ? 1ULL << (n - LANE_ATOMS) : 1;
+
+    // the wide kernels leave only a few blocks to the scalar one
+    Jit *jit = selected == SWEEP_SCALAR && blocks >= JIT_BLOCKS ? compile_jit(program, JIT_COLUMNS) : NULL;
+
+    uint64_t r;
+    int n_threads = get_sweep_threads();
+    if (n_threads < 2 || blocks < 2 * CHUNK_BLOCKS) {
+        bool found = kernel(program, jit, 0, blocks, row ? row : &r);
+        free_jit(jit);
+        return found;
+    }
+    if ((uint64_t) n_threads > blocks / CHUNK_BLOCKS) {
+        n_threads = (int) (blocks / CHUNK_BLOCKS);
+    }
+
+    Sweep sweep;
+    sweep.program = program;
+    sweep.jit = jit;
+    sweep.blocks = blocks;
+    atomic_init(&sweep.next, 0);
+    atomic_init(&sweep.found, false);
+    g_mutex_init(&sweep.lock);
+    sweep.row = 0;
+
+    GThread **workers = g_new(GThread *, n_threads);
+    for (int i = 0; i < n_threads; i++) {
+        workers[i] = g_thread_new("sweep", sweep_worker, &sweep);
+    }
+    for (int i = 0; i < n_threads; i++) {
+        g_thread_join(workers[i]);
+    }
+    g_free(workers);
+    g_mutex_clear(&sweep.lock);
+    free_jit(jit);
+
+    if (row) {
+        *row = sweep.row;
+    }
+    return atomic_load(&sweep.found);
+}
@@ -0,0 +1,110 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <string.h>
+#include "../include/symbols.h"
+
+// the names are looked up by their spans, hence a span of a script is copied only when it is new
+typedef struct {
+    const char *text;
+    size_t length;
+} Span;
+
+// the table is shared by all the threads, and guarded by a lock
+static GHashTable *ids = NULL;
+static GPtrArray *names = NULL;
+static GMutex lock;
+
+static guint hash_span(gconstpointer key) {
+    const Span *span = (const Span *) key;
+    guint h = 5381;
+    for (size_t i = 0; i < span->length; i++) {
+        h = h * 33 + (unsigned char) span->text[i];
+    }
+    return h;
+}
+
+static gboolean equal_spans(gconstpointer a, gconstpointer b) {
+    const Span *x = (const Span *) a;
+    const Span *y = (const Span *) b;
+    return x->length == y->length && memcmp(x->text, y->text, x->length) == 0;
+}
+
+int intern_atom(const char *name) {
+    return intern_atom_span(name, strlen(name));
+}
+
+int intern_atom_span(const char *name, size_t length) {
+    g_mutex_lock(&lock);
+    if (ids == NULL) {
+        ids = g_hash_table_new_full(hash_span, equal_spans, g_free, NULL);
+        names = g_ptr_array_new();
+    }
+
+    Span probe = {name, length};
+    gpointer id;
+    if (g_hash_table_lookup_extended(ids, &probe, NULL, &id)) {
+        g_mutex_unlock(&lock);
+        return GPOINTER_TO_INT(id);
+    }
+    Span *span = g_new(Span, 1);
+    span->text = g_strndup(name, length);
+    span->length = length;
+    int atom = (int) names->len;
+    g_ptr_array_add(names, (gpointer) span->text);
+    g_hash_table_insert(ids, span, GINT_TO_POINTER(atom));
+    g_mutex_unlock(&lock);
+    return atom;
+}
+
+const char *atom_name(int atom) {
+    g_mutex_lock(&lock);
+    const char *name = (const char *) g_ptr_array_index(names, atom);
+    g_mutex_unlock(&lock);
+    return name;
+}
+
+int count_atoms() {
+    g_mutex_lock(&lock);
+    int n = names == NULL ? 0 : (int) names->len;
+    g_mutex_unlock(&lock);
+    return n;
+}
+
+Valuation *create_valuation() {
+    Valuation *v = malloc(sizeof(Valuation));
+    v->assigned = NULL;
+    v->values = NULL;
+    v->words = 0;
+    return v;
+}
+
+void free_valuation(Valuation *valuation) {
+    free(valuation->assigned);
+    free(valuation->values);
+    free(valuation);
+}
+
+void set_atom_value(Valuation *valuation, int atom, bool value) {
+    size_t word = (size_t) atom >> 6;
+    if (word >= valuation->words) {
+        size_t words = valuation->words == 0 ? 1 : valuation->words;
+        while (words <= word) {
+            words *= 2;
+        }
+        valuation->assigned = realloc(valuation->assigned, words * sizeof(uint64_t));
+        valuation->values = realloc(valuation->values, words * sizeof(uint64_t));
+        memset(valuation->assigned + valuation->words, 0, (words - valuation->words) * sizeof(uint64_t));
+        memset(valuation->values + valuation->words, 0, (words - valuation->words) * sizeof(uint64_t));
+        valuation->words = words;
+    }
+
+    uint64_t bit = 1ULL << (atom & 63);
+    valuation->assigned[word] |= bit;
+    if (value) {
+        valuation->values[word] |= bit;
+    } else {
+        valuation->values[word] &= ~bit;
+    }
+}
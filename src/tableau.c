@@ -0,0 +1,276 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "../include/symbols.h"
+#include "../include/tableau.h"
+#include "../include/wff.h"
+
+typedef struct {
+    Wff *wff;
+    bool sign;
+} Signed;
+
+// A branch holds the signed wffs which are still to be expanded, the non-branching ones apart,
+// and the values which it gives to the atoms: 1 true, -1 false, and 0 none
+typedef struct {
+    GArray *alphas;
+    GArray *betas;
+    signed char *values;
+} Branch;
+
+// the branches of a thread: the thread takes the newest one, and the thieves the oldest one
+typedef struct {
+    GMutex lock;
+    GQueue *branches;
+} Deque;
+
+typedef struct {
+    int n_atoms;
+    int n_threads;
+    Deque *deques;
+    // the branches which are either in a deque or being expanded
+    atomic_long pending;
+    atomic_bool open;
+    // the threads which find no branch sleep on the condition until a branch is shared, which they
+    // tell by the number of the shared branches, or until the tableau is done
+    GMutex idle_lock;
+    GCond idle;
+    atomic_int sleeping;
+    atomic_long shared;
+} Tableau;
+
+typedef struct {
+    Tableau *tableau;
+    int id;
+} Worker;
+
+static Branch *create_branch(int n_atoms) {
+    Branch *b = malloc(sizeof(Branch));
+    b->alphas = g_array_new(FALSE, FALSE, sizeof(Signed));
+    b->betas = g_array_new(FALSE, FALSE, sizeof(Signed));
+    b->values = calloc(n_atoms > 0 ? n_atoms : 1, sizeof(signed char));
+    return b;
+}
+
+static Branch *copy_branch(const Branch *branch, int n_atoms) {
+    Branch *b = create_branch(n_atoms);
+    g_array_append_vals(b->alphas, branch->alphas->data, branch->alphas->len);
+    g_array_append_vals(b->betas, branch->betas->data, branch->betas->len);
+    memcpy(b->values, branch->values, n_atoms);
+    return b;
+}
+
+static void free_branch(Branch *b) {
+    g_array_free(b->alphas, TRUE);
+    g_array_free(b->betas, TRUE);
+    free(b->values);
+    free(b);
+}
+
+// strips the negations, which only flip the sign
+static Signed strip(Wff *wff, bool sign) {
+    while (wff->type == WFF_NEGATION) {
+        wff = wff->wff1;
+        sign = !sign;
+    }
+    Signed s = {wff, sign};
+    return s;
+}
+
+static bool is_beta(Signed s) {
+    return (s.wff->type == WFF_CONJUNCTION && !s.sign) ||
+           (s.wff->type == WFF_DISJUNCTION && s.sign) ||
+           (s.wff->type == WFF_CONDITIONAL && s.sign);
+}
+
+// the two signed wffs which a rule derives from s
+static void decompose(Signed s, Signed *left, Signed *right) {
+    bool left_sign = s.wff->type == WFF_CONDITIONAL ? !s.sign : s.sign;
+    *left = strip(s.wff->wff1, left_sign);
+    *right = strip(s.wff->wff2, s.sign);
+}
+
+// 1 if the literal holds in the branch, -1 if its negation does, and 0 otherwise
+static int literal_value(const Branch *b, Signed s) {
+    if (s.wff->type != WFF_ATOMIC_CONDITION) {
+        return 0;
+    }
+    int value = b->values[s.wff->atom];
+    return s.sign ? value : -value;
+}
+
+// adds a signed wff to the branch, and returns false if the branch closes
+static bool add(Branch *b, Signed s) {
+    if (s.wff->type == WFF_ATOMIC_CONDITION) {
+        signed char value = s.sign ? 1 : -1;
+        if (b->values[s.wff->atom] == -value) {
+            return false;
+        }
+        b->values[s.wff->atom] = value;
+    } else if (is_beta(s)) {
+        g_array_append_val(b->betas, s);
+    } else {
+        g_array_append_val(b->alphas, s);
+    }
+    return true;
+}
+
+static void share(Tableau *t, int id, Branch *b) {
+    atomic_fetch_add(&t->pending, 1);
+    Deque *d = &t->deques[id];
+    g_mutex_lock(&d->lock);
+    g_queue_push_tail(d->branches, b);
+    g_mutex_unlock(&d->lock);
+    atomic_fetch_add(&t->shared, 1);
+    if (atomic_load(&t->sleeping) > 0) {
+        g_mutex_lock(&t->idle_lock);
+        g_cond_signal(&t->idle);
+        g_mutex_unlock(&t->idle_lock);
+    }
+}
+
+static Branch *take(Tableau *t, int id) {
+    Deque *d = &t->deques[id];
+    g_mutex_lock(&d->lock);
+    Branch *b = g_queue_pop_tail(d->branches);
+    g_mutex_unlock(&d->lock);
+    for (int i = 1; b == NULL && i < t->n_threads; i++) {
+        d = &t->deques[(id + i) % t->n_threads];
+        g_mutex_lock(&d->lock);
+        b = g_queue_pop_head(d->branches);
+        g_mutex_unlock(&d->lock);
+    }
+    return b;
+}
+
+// expands a branch until it closes or is saturated, and shares the right sides of its splits
+static void expand(Tableau *t, int id, Branch *b) {
+    while (!atomic_load_explicit(&t->open, memory_order_relaxed)) {
+        while (b->alphas->len > 0) {
+            Signed s = g_array_index(b->alphas, Signed, b->alphas->len - 1);
+            g_array_set_size(b->alphas, b->alphas->len - 1);
+            Signed left, right;
+            decompose(s, &left, &right);
+            if (!add(b, left) || !add(b, right)) {
+                return;
+            }
+        }
+
+        if (b->betas->len == 0) {
+            atomic_store(&t->open, true);
+            return;
+        }
+
+        Signed s = g_array_index(b->betas, Signed, b->betas->len - 1);
+        g_array_set_size(b->betas, b->betas->len - 1);
+        Signed left, right;
+        decompose(s, &left, &right);
+
+        // a side which already holds satisfies the wff, and a side which cannot hold needs no branch
+        int l = literal_value(b, left);
+        int r = literal_value(b, right);
+        if (l == 1 || r == 1) {
+            continue;
+        }
+        if (l == -1 || r == -1) {
+            if (!add(b, l == -1 ? right : left)) {
+                return;
+            }
+            continue;
+        }
+
+        Branch *c = copy_branch(b, t->n_atoms);
+        add(c, right);
+        share(t, id, c);
+        add(b, left);
+    }
+}
+
+static gpointer work(gpointer data) {
+    Worker *w = (Worker *) data;
+    Tableau *t = w->tableau;
+    while (!atomic_load(&t->open) && atomic_load(&t->pending) > 0) {
+        long seen = atomic_load(&t->shared);
+        Branch *b = take(t, w->id);
+        if (b == NULL) {
+            g_mutex_lock(&t->idle_lock);
+            atomic_fetch_add(&t->sleeping, 1);
+            while (!atomic_load(&t->open) && atomic_load(&t->pending) > 0 && atomic_load(&t->shared) == seen) {
+                g_cond_wait(&t->idle, &t->idle_lock);
+            }
+            atomic_fetch_sub(&t->sleeping, 1);
+            g_mutex_unlock(&t->idle_lock);
+            continue;
+        }
+        expand(t, w->id, b);
+        free_branch(b);
+        // the last branch, or an open one, ends the tableau for all the threads
+        if (atomic_fetch_sub(&t->pending, 1) == 1 || atomic_load(&t->open)) {
+            g_mutex_lock(&t->idle_lock);
+            g_cond_broadcast(&t->idle);
+            g_mutex_unlock(&t->idle_lock);
+        }
+    }
+    return NULL;
+}
+
+bool tableau_satisfiable(GSList *formulae, int n_threads) {
+    Tableau t;
+    t.n_atoms = count_atoms();
+    t.n_threads = n_threads > 0 ? n_threads : 1;
+    t.deques = g_new(Deque, t.n_threads);
+    for (int i = 0; i < t.n_threads; i++) {
+        g_mutex_init(&t.deques[i].lock);
+        t.deques[i].branches = g_queue_new();
+    }
+    atomic_init(&t.pending, 0);
+    atomic_init(&t.open, false);
+    g_mutex_init(&t.idle_lock);
+    g_cond_init(&t.idle);
+    atomic_init(&t.sleeping, 0);
+    atomic_init(&t.shared, 0);
+
+    // the root branch claims that all the formulae are true
+    Branch *root = create_branch(t.n_atoms);
+    bool closed = false;
+    for (GSList *list = formulae; list != NULL && !closed; list = list->next) {
+        closed = !add(root, strip((Wff *) list->data, true));
+    }
+    if (closed) {
+        free_branch(root);
+    } else {
+        share(&t, 0, root);
+    }
+
+    Worker *workers = g_new(Worker, t.n_threads);
+    GThread **threads = g_new(GThread *, t.n_threads);
+    for (int i = 0; i < t.n_threads; i++) {
+        workers[i].tableau = &t;
+        workers[i].id = i;
+    }
+    for (int i = 1; i < t.n_threads; i++) {
+        threads[i] = g_thread_new("tableau", work, &workers[i]);
+    }
+    work(&workers[0]);
+    for (int i = 1; i < t.n_threads; i++) {
+        g_thread_join(threads[i]);
+    }
+
+    // the branches left when an open one is found are dropped
+    for (int i = 0; i < t.n_threads; i++) {
+        for (Branch *b; (b = g_queue_pop_head(t.deques[i].branches)) != NULL;) {
+            free_branch(b);
+        }
+        g_queue_free(t.deques[i].branches);
+        g_mutex_clear(&t.deques[i].lock);
+    }
+    g_cond_clear(&t.idle);
+    g_mutex_clear(&t.idle_lock);
+    g_free(threads);
+    g_free(workers);
+    g_free(t.deques);
+    return atomic_load(&t.open);
+}
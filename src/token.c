@@ -1,8 +1,9 @@
 /*
  * © 2023-2025 Daniele Di Salvo
  */
-#include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../include/token.h"
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
@@ -36,6 +37,7 @@ static const TokenType assign_tokens[] = {
         TOKEN_FALSE,
         TOKEN_LEFT_BRACKET,
         TOKEN_NOT,
+        TOKEN_STRING,
         TOKEN_TRUE
 };
 
@@ -56,6 +58,14 @@ static const TokenType comma_tokens[] = {
         TOKEN_NOT
 };
 
+static const TokenType count_tokens[] = {
+        TOKEN_IDENTIFIER
+};
+
+static const TokenType export_tokens[] = {
+        TOKEN_IDENTIFIER
+};
+
 static const TokenType identifier_tokens[] = {
         TOKEN_ASSIGN
 };
@@ -111,184 +121,148 @@ static const TokenType valuate_tokens[] = {
         TOKEN_IDENTIFIER
 };
 
-Token *create_and_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_AND;
-    t->value = strdup("&");
-    return t;
-}
-
-Token *create_argument_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_ARGUMENT;
-    t->value = strdup("argument");
-    return t;
-}
-
-
-Token *create_assert_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_ASSERT;
-    t->value = strdup("assert");
-    return t;
-}
-
-Token *create_assign_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_ASSIGN;
-    t->value = strdup(":=");
-    return t;
-}
-
-Token *create_atom_token(const char *value) {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_ATOM;
-    t->value = strdup(value);
-    return t;
-}
-
-Token *create_comma_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_COMMA;
-    t->value = strdup(",");
-    return t;
-}
-
-Token *create_false_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_FALSE;
-    t->value = strdup("false");
-    return t;
-}
-
-Token *create_identifier_token(const char *value) {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_IDENTIFIER;
-    t->value = strdup(value);
-    return t;
-}
-
-Token *create_left_bracket_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_LEFT_BRACKET;
-    t->value = strdup("(");
-    return t;
-}
-
-Token *create_material_implication_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_MATERIAL_IMPLICATION;
-    t->value = strdup("->");
-    return t;
-}
-
-Token *create_not_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_NOT;
-    t->value = strdup("!");
-    return t;
-}
+// the text of the tokens which are not spans of the script
+static const char *const spellings[] = {
+        [TOKEN_AND] = "&",
+        [TOKEN_ARGUMENT] = "argument",
+        [TOKEN_ASSERT] = "assert",
+        [TOKEN_ASSIGN] = ":=",
+        [TOKEN_COMMA] = ",",
+        [TOKEN_COUNT] = "count",
+        [TOKEN_EXPORT] = "export",
+        [TOKEN_FALSE] = "false",
+        [TOKEN_LEFT_BRACKET] = "(",
+        [TOKEN_MATERIAL_IMPLICATION] = "->",
+        [TOKEN_NOT] = "!",
+        [TOKEN_OR] = "|",
+        [TOKEN_PRINT] = "print",
+        [TOKEN_RIGHT_BRACKET] = ")",
+        [TOKEN_THEREFORE] = "=>",
+        [TOKEN_TRUE] = "true",
+        [TOKEN_VALIDATE] = "validate",
+        [TOKEN_VALUATE] = "valuate"
+};
 
-Token *create_or_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_OR;
-    t->value = strdup("|");
-    return t;
+TokenStream *create_token_stream(const char *text) {
+    TokenStream *stream = calloc(1, sizeof(TokenStream));
+    stream->text = text;
+    stream->statements_capacity = 16;
+    stream->statements = malloc(stream->statements_capacity * sizeof(uint32_t));
+    stream->statements[0] = 0;
+    return stream;
 }
 
-Token *create_print_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_PRINT;
-    t->value = strdup("print");
-    return t;
+void add_token(TokenStream *stream, TokenType type, size_t offset, size_t length, int atom) {
+    if (stream->n_tokens == stream->capacity) {
+        stream->capacity = stream->capacity > 0 ? 2 * stream->capacity : 256;
+        stream->types = realloc(stream->types, stream->capacity * sizeof(uint8_t));
+        stream->offsets = realloc(stream->offsets, stream->capacity * sizeof(uint32_t));
+        stream->lengths = realloc(stream->lengths, stream->capacity * sizeof(uint32_t));
+        stream->atoms = realloc(stream->atoms, stream->capacity * sizeof(int32_t));
+    }
+    size_t i = stream->n_tokens++;
+    stream->types[i] = (uint8_t) type;
+    stream->offsets[i] = (uint32_t) offset;
+    stream->lengths[i] = (uint32_t) length;
+    stream->atoms[i] = atom;
 }
 
-Token *create_right_bracket_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_RIGHT_BRACKET;
-    t->value = strdup(")");
-    return t;
+void end_statement(TokenStream *stream) {
+    if (stream->statements[stream->n_statements] == stream->n_tokens) {
+        return;
+    }
+    if (stream->n_statements + 2 > stream->statements_capacity) {
+        stream->statements_capacity *= 2;
+        stream->statements = realloc(stream->statements, stream->statements_capacity * sizeof(uint32_t));
+    }
+    stream->statements[++stream->n_statements] = (uint32_t) stream->n_tokens;
 }
 
-Token *create_string_token(const char *value) {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_STRING;
-    t->value = strdup(value);
-    return t;
+Token get_token(const TokenStream *stream, size_t i) {
+    Token token;
+    token.type = (TokenType) stream->types[i];
+    token.atom = stream->atoms[i];
+    if (token.type == TOKEN_ATOM || token.type == TOKEN_IDENTIFIER || token.type == TOKEN_STRING) {
+        token.text = stream->text + stream->offsets[i];
+        token.length = stream->lengths[i];
+    } else {
+        token.text = spellings[token.type];
+        token.length = strlen(token.text);
+    }
+    return token;
 }
 
-Token *create_therefore_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_THEREFORE;
-    t->value = strdup("=>");
-    return t;
+void free_token_stream(TokenStream *stream) {
+    free(stream->types);
+    free(stream->offsets);
+    free(stream->lengths);
+    free(stream->atoms);
+    free(stream->statements);
+    free(stream);
 }
 
-Token *create_true_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_TRUE;
-    t->value = strdup("true");
-    return t;
+TokenCursor statement_cursor(const TokenStream *stream, size_t statement) {
+    TokenCursor cursor = {stream, stream->statements[statement], stream->statements[statement + 1]};
+    return cursor;
 }
 
-Token *create_validate_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_VALIDATE;
-    t->value = strdup("validate");
-    return t;
+bool peek_token(const TokenCursor *cursor, Token *token) {
+    if (cursor->next >= cursor->end) {
+        return false;
+    }
+    if (token != NULL) {
+        *token = get_token(cursor->stream, cursor->next);
+    }
+    return true;
 }
 
-Token *create_valuate_token() {
-    Token *t = malloc(sizeof(Token));
-    t->type = TOKEN_VALUATE;
-    t->value = strdup("valuate");
-    return t;
+bool pop_token(TokenCursor *cursor, Token *token) {
+    if (!peek_token(cursor, token)) {
+        return false;
+    }
+    cursor->next++;
+    return true;
 }
 
-bool can_follow(const Token *current, const Token *next) {
-    switch (current->type) {
+bool can_follow(TokenType current, TokenType next) {
+    switch (current) {
         case TOKEN_AND:
-            return IS_VALID_TOKEN(and_tokens, next->type);
+            return IS_VALID_TOKEN(and_tokens, next);
         case TOKEN_ARGUMENT:
-            return IS_VALID_TOKEN(argument_tokens, next->type);
+            return IS_VALID_TOKEN(argument_tokens, next);
         case TOKEN_ASSERT:
-            return IS_VALID_TOKEN(assert_tokens, next->type);
+            return IS_VALID_TOKEN(assert_tokens, next);
         case TOKEN_ASSIGN:
-            return IS_VALID_TOKEN(assign_tokens, next->type);
+            return IS_VALID_TOKEN(assign_tokens, next);
         case TOKEN_ATOM:
-            return IS_VALID_TOKEN(atom_tokens, next->type);
+            return IS_VALID_TOKEN(atom_tokens, next);
         case TOKEN_COMMA:
-            return IS_VALID_TOKEN(comma_tokens, next->type);
+            return IS_VALID_TOKEN(comma_tokens, next);
+        case TOKEN_COUNT:
+            return IS_VALID_TOKEN(count_tokens, next);
+        case TOKEN_EXPORT:
+            return IS_VALID_TOKEN(export_tokens, next);
         case TOKEN_IDENTIFIER:
-            return IS_VALID_TOKEN(identifier_tokens, next->type);
+            return IS_VALID_TOKEN(identifier_tokens, next);
         case TOKEN_LEFT_BRACKET:
-            return IS_VALID_TOKEN(left_bracket_tokens, next->type);
+            return IS_VALID_TOKEN(left_bracket_tokens, next);
         case TOKEN_MATERIAL_IMPLICATION:
-            return IS_VALID_TOKEN(material_implication_tokens, next->type);
+            return IS_VALID_TOKEN(material_implication_tokens, next);
         case TOKEN_NOT:
-            return IS_VALID_TOKEN(not_tokens, next->type);
+            return IS_VALID_TOKEN(not_tokens, next);
         case TOKEN_OR:
-            return IS_VALID_TOKEN(or_tokens, next->type);
+            return IS_VALID_TOKEN(or_tokens, next);
         case TOKEN_PRINT:
-            return IS_VALID_TOKEN(print_tokens, next->type);
+            return IS_VALID_TOKEN(print_tokens, next);
         case TOKEN_RIGHT_BRACKET:
-            return IS_VALID_TOKEN(right_bracket_tokens, next->type);
+            return IS_VALID_TOKEN(right_bracket_tokens, next);
         case TOKEN_THEREFORE:
-            return IS_VALID_TOKEN(therefore_tokens, next->type);
+            return IS_VALID_TOKEN(therefore_tokens, next);
         case TOKEN_VALIDATE:
-            return IS_VALID_TOKEN(validate_tokens, next->type);
+            return IS_VALID_TOKEN(validate_tokens, next);
         case TOKEN_VALUATE:
-            return IS_VALID_TOKEN(valuate_tokens, next->type);
+            return IS_VALID_TOKEN(valuate_tokens, next);
         default:
             return true;
     }
 }
-
-void free_token(Token *token) {
-    free(token->value);
-    free(token);
-}
-
-void free_token_func(gpointer data) {
-    free_token((Token *) data);
-}
@@ -0,0 +1,239 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <string.h>
+#include "../include/truth_table.h"
+
+// the columns of the first six slots are the same in every word
+static const uint64_t lane_masks[] = {
+        0xAAAAAAAAAAAAAAAAULL,
+        0xCCCCCCCCCCCCCCCCULL,
+        0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL,
+        0xFFFF0000FFFF0000ULL,
+        0xFFFFFFFF00000000ULL
+};
+
+#define LANE_ATOMS 6
+
+// the cache stops growing when its tables exceed 64 MiB
+#define MAX_CACHED_WORDS (1u << 23)
+
+// the tables by the canonical identifier of their wff, in the high half of the key the index of
+// their set of atoms. The cache is shared by all the threads, and guarded by a lock: a table is
+// never changed once it is cached, and it is only freed when the cache is cleared, hence it is
+// read without the lock
+static GHashTable *cache = NULL;
+static GHashTable *atom_sets = NULL;
+static size_t cached_words = 0;
+static GMutex lock;
+
+void clear_truth_tables() {
+    g_mutex_lock(&lock);
+    if (cache != NULL) {
+        g_hash_table_destroy(cache);
+        g_hash_table_destroy(atom_sets);
+        cache = NULL;
+        atom_sets = NULL;
+        cached_words = 0;
+    }
+    g_mutex_unlock(&lock);
+}
+
+// the state of the building of a table
+typedef struct {
+    const TruthTable *table;
+    gint64 set;
+    // the projection masks of the slots, and the slot of every atom
+    uint64_t **projections;
+    GHashTable *slots;
+    // the tables of the wffs which are not cached
+    GHashTable *memo;
+} Builder;
+
+// adds the atoms of the wff, and returns false as soon as there are too many of them
+static bool collect_atoms(Wff *wff, GHashTable *visited, TruthTable *table) {
+    if (!g_hash_table_add(visited, wff)) {
+        return true;
+    }
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        for (int i = 0; i < table->n_atoms; i++) {
+            if (table->atoms[i] == wff->atom) {
+                return true;
+            }
+        }
+        if (table->n_atoms == MAX_TABLE_ATOMS) {
+            return false;
+        }
+        table->atoms[table->n_atoms++] = wff->atom;
+        return true;
+    }
+    return collect_atoms(wff->wff1, visited, table) &&
+           (wff->type == WFF_NEGATION || collect_atoms(wff->wff2, visited, table));
+}
+
+static int compare_atoms(const void *a, const void *b) {
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return x < y ? -1 : x > y;
+}
+
+static uint64_t *table_of(Builder *b, Wff *wff) {
+    size_t n = b->table->n_words;
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        return b->projections[GPOINTER_TO_INT(g_hash_table_lookup(b->slots, GINT_TO_POINTER(wff->atom)))];
+    }
+
+    gint64 key = (b->set << 32) | wff->id;
+    uint64_t *known = g_hash_table_lookup(b->memo, wff);
+    if (known == NULL && wff->id >= 0) {
+        g_mutex_lock(&lock);
+        known = g_hash_table_lookup(cache, &key);
+        g_mutex_unlock(&lock);
+    }
+    if (known != NULL) {
+        return known;
+    }
+
+    uint64_t *x = table_of(b, wff->wff1);
+    uint64_t *words = malloc(n * sizeof(uint64_t));
+    if (wff->type == WFF_NEGATION) {
+        for (size_t i = 0; i < n; i++) {
+            words[i] = ~x[i];
+        }
+    } else {
+        uint64_t *y = table_of(b, wff->wff2);
+        if (wff->type == WFF_CONJUNCTION) {
+            for (size_t i = 0; i < n; i++) {
+                words[i] = x[i] & y[i];
+            }
+        } else if (wff->type == WFF_DISJUNCTION) {
+            for (size_t i = 0; i < n; i++) {
+                words[i] = x[i] | y[i];
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                words[i] = ~x[i] | y[i];
+            }
+        }
+    }
+
+    // another thread may have cached the same table meanwhile, and then its table is kept
+    bool cached = false;
+    if (wff->id >= 0) {
+        g_mutex_lock(&lock);
+        known = g_hash_table_lookup(cache, &key);
+        if (known != NULL) {
+            free(words);
+            words = known;
+            cached = true;
+        } else if (cached_words <= MAX_CACHED_WORDS) {
+            gint64 *k = g_new(gint64, 1);
+            *k = key;
+            g_hash_table_insert(cache, k, words);
+            cached_words += n;
+            cached = true;
+        }
+        g_mutex_unlock(&lock);
+    }
+    if (!cached) {
+        g_hash_table_insert(b->memo, wff, words);
+    }
+    return words;
+}
+
+TruthTable *create_truth_table(GSList *formulae) {
+    TruthTable *table = malloc(sizeof(TruthTable));
+    table->n_atoms = 0;
+    GHashTable *visited = g_hash_table_new(g_direct_hash, g_direct_equal);
+    bool few = true;
+    for (GSList *list = formulae; list != NULL && few; list = list->next) {
+        few = collect_atoms((Wff *) list->data, visited, table);
+    }
+    g_hash_table_destroy(visited);
+    if (!few) {
+        free(table);
+        return NULL;
+    }
+    qsort(table->atoms, table->n_atoms, sizeof(int), compare_atoms);
+    table->n_words = table->n_atoms > LANE_ATOMS ? (size_t) 1 << (table->n_atoms - LANE_ATOMS) : 1;
+    table->words = malloc(table->n_words * sizeof(uint64_t));
+
+    Builder b;
+    b.table = table;
+    GString *set = g_string_new(NULL);
+    for (int i = 0; i < table->n_atoms; i++) {
+        g_string_append_printf(set, "%d,", table->atoms[i]);
+    }
+    gpointer index;
+    g_mutex_lock(&lock);
+    if (cache == NULL) {
+        cache = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, free);
+        atom_sets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    }
+    if (g_hash_table_lookup_extended(atom_sets, set->str, NULL, &index)) {
+        b.set = GPOINTER_TO_INT(index);
+        g_string_free(set, TRUE);
+    } else {
+        b.set = g_hash_table_size(atom_sets);
+        g_hash_table_insert(atom_sets, g_string_free(set, FALSE), GINT_TO_POINTER((int) b.set));
+    }
+    g_mutex_unlock(&lock);
+
+    b.slots = g_hash_table_new(g_direct_hash, g_direct_equal);
+    b.projections = malloc((table->n_atoms > 0 ? table->n_atoms : 1) * sizeof(uint64_t *));
+    for (int j = 0; j < table->n_atoms; j++) {
+        g_hash_table_insert(b.slots, GINT_TO_POINTER(table->atoms[j]), GINT_TO_POINTER(j));
+        b.projections[j] = malloc(table->n_words * sizeof(uint64_t));
+        for (size_t i = 0; i < table->n_words; i++) {
+            // the slots beyond the sixth one are constant within a word, and take the bits of its index
+            b.projections[j][i] = j < LANE_ATOMS ? lane_masks[j] : (i >> (j - LANE_ATOMS)) & 1 ? ~0ULL : 0;
+        }
+    }
+    b.memo = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+
+    for (size_t i = 0; i < table->n_words; i++) {
+        table->words[i] = ~0ULL;
+    }
+    for (GSList *list = formulae; list != NULL; list = list->next) {
+        uint64_t *words = table_of(&b, (Wff *) list->data);
+        for (size_t i = 0; i < table->n_words; i++) {
+            table->words[i] &= words[i];
+        }
+    }
+    // the rows beyond the last one of a table of fewer than six atoms are false
+    if (table->n_atoms < LANE_ATOMS) {
+        table->words[0] &= (1ULL << (1 << table->n_atoms)) - 1;
+    }
+
+    for (int j = 0; j < table->n_atoms; j++) {
+        free(b.projections[j]);
+    }
+    free(b.projections);
+    g_hash_table_destroy(b.slots);
+    g_hash_table_destroy(b.memo);
+    return table;
+}
+
+void free_truth_table(TruthTable *table) {
+    free(table->words);
+    free(table);
+}
+
+bool truth_table_satisfiable(const TruthTable *table) {
+    for (size_t i = 0; i < table->n_words; i++) {
+        if (table->words[i] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool truth_table_value(const TruthTable *table, const Valuation *values) {
+    size_t row = 0;
+    for (int j = 0; j < table->n_atoms; j++) {
+        row |= (size_t) get_atom_value(values, table->atoms[j]) << j;
+    }
+    return (table->words[row >> 6] >> (row & 63)) & 1;
+}
@@ -0,0 +1,160 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <stdio.h>
+#include "../include/unique.h"
+
+// the canonical form of a node: its type, and either its atom or the identifiers of its operands
+typedef struct {
+    int type;
+    int a;
+    int b;
+} Canon;
+
+// the tables are shared by all the threads, hence the canonical identifiers are the same for all
+// of them, and they are guarded by a lock
+static GHashTable *nodes = NULL;
+static GHashTable *canons = NULL;
+static GMutex lock;
+
+static guint hash_node(gconstpointer key) {
+    const Wff *wff = (const Wff *) key;
+    guint h = (guint) wff->type * 31u + (guint) wff->atom;
+    h = h * 31u + g_direct_hash(wff->wff1);
+    return h * 31u + g_direct_hash(wff->wff2);
+}
+
+static gboolean equal_nodes(gconstpointer a, gconstpointer b) {
+    const Wff *x = (const Wff *) a;
+    const Wff *y = (const Wff *) b;
+    return x->type == y->type && x->atom == y->atom && x->wff1 == y->wff1 && x->wff2 == y->wff2;
+}
+
+static guint hash_canon(gconstpointer key) {
+    const Canon *c = (const Canon *) key;
+    return ((guint) c->type * 31u + (guint) c->a) * 31u + (guint) c->b;
+}
+
+static gboolean equal_canons(gconstpointer a, gconstpointer b) {
+    const Canon *x = (const Canon *) a;
+    const Canon *y = (const Canon *) b;
+    return x->type == y->type && x->a == y->a && x->b == y->b;
+}
+
+static void init_tables() {
+    if (nodes == NULL) {
+        nodes = g_hash_table_new(hash_node, equal_nodes);
+        canons = g_hash_table_new_full(hash_canon, equal_canons, g_free, NULL);
+    }
+}
+
+static int canonical_id(WffType type, int a, int b) {
+    // the operands of the commutative operators are sorted
+    if ((type == WFF_CONJUNCTION || type == WFF_DISJUNCTION) && a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    Canon key = {type, a, b};
+    gpointer id;
+    if (g_hash_table_lookup_extended(canons, &key, NULL, &id)) {
+        return GPOINTER_TO_INT(id);
+    }
+    Canon *c = g_new(Canon, 1);
+    *c = key;
+    int n = (int) g_hash_table_size(canons);
+    g_hash_table_insert(canons, c, GINT_TO_POINTER(n));
+    return n;
+}
+
+// returns the node equal to the probe, or a new one
+static Wff *intern(const Wff *probe, int a, int b) {
+    g_mutex_lock(&lock);
+    init_tables();
+    Wff *wff = g_hash_table_lookup(nodes, probe);
+    if (wff != NULL) {
+        g_mutex_unlock(&lock);
+        return wff;
+    }
+
+    if (probe->type == WFF_ATOMIC_CONDITION) {
+        wff = create_interned_atomic_condition(probe->atom);
+    } else if (probe->type == WFF_NEGATION) {
+        wff = create_negation(probe->wff1);
+    } else if (probe->type == WFF_CONJUNCTION) {
+        wff = create_conjunction(probe->wff1, probe->wff2);
+    } else if (probe->type == WFF_DISJUNCTION) {
+        wff = create_disjunction(probe->wff1, probe->wff2);
+    } else {
+        wff = create_conditional(probe->wff1, probe->wff2);
+    }
+    wff->id = canonical_id(probe->type, a, b);
+    g_hash_table_insert(nodes, wff, wff);
+    g_mutex_unlock(&lock);
+    return wff;
+}
+
+Wff *unique_atomic_condition(int atom) {
+    Wff probe = {.type = WFF_ATOMIC_CONDITION, .atom = atom};
+    return intern(&probe, atom, -1);
+}
+
+Wff *unique_negation(Wff *wff1) {
+    Wff probe = {.type = WFF_NEGATION, .wff1 = wff1, .atom = -1};
+    return intern(&probe, wff1->id, -1);
+}
+
+Wff *unique_binary(WffType type, Wff *wff1, Wff *wff2) {
+    Wff probe = {.type = type, .wff1 = wff1, .wff2 = wff2, .atom = -1};
+    return intern(&probe, wff1->id, wff2->id);
+}
+
+void clear_unique_table() {
+    g_mutex_lock(&lock);
+    if (nodes != NULL) {
+        g_hash_table_destroy(nodes);
+        g_hash_table_destroy(canons);
+        nodes = NULL;
+        canons = NULL;
+    }
+    g_mutex_unlock(&lock);
+}
+
+static gint compare_ids(gconstpointer a, gconstpointer b) {
+    int x = *(const int *) a;
+    int y = *(const int *) b;
+    return x < y ? -1 : x > y;
+}
+
+char *argument_key(const Wff *argument) {
+    if (argument->wff1 != NULL && argument->wff1->id < 0) {
+        return NULL;
+    }
+
+    GArray *ids = g_array_new(FALSE, FALSE, sizeof(int));
+    for (GSList *premises = argument->premises; premises != NULL; premises = premises->next) {
+        int id = ((Wff *) premises->data)->id;
+        if (id < 0) {
+            g_array_free(ids, TRUE);
+            return NULL;
+        }
+        g_array_append_val(ids, id);
+    }
+    g_array_sort(ids, compare_ids);
+
+    // the premises are a set, hence the duplicates are skipped
+    GString *key = g_string_new("");
+    for (guint i = 0; i < ids->len; i++) {
+        int id = g_array_index(ids, int, i);
+        if (i == 0 || id != g_array_index(ids, int, i - 1)) {
+            g_string_append_printf(key, "%d,", id);
+        }
+    }
+    g_string_append(key, "=>");
+    if (argument->wff1 != NULL) {
+        g_string_append_printf(key, "%d", argument->wff1->id);
+    }
+    g_array_free(ids, TRUE);
+    return g_string_free(key, FALSE);
+}
@@ -0,0 +1,344 @@
+/*
+ * © 2023-2025 Daniele Di Salvo
+ */
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/symbols.h"
+#include "../include/verdict_cache.h"
+
+// "ARISVC01"
+#define MAGIC 0x3130435653495241ull
+
+// the number of slots where a key can be
+#define WINDOW 8
+
+typedef struct {
+    uint64_t magic;
+    uint32_t n_slots;
+    uint32_t clock;
+} Header;
+
+typedef struct {
+    uint64_t h1;
+    uint64_t h2;
+    uint32_t verdict;
+    uint32_t check;
+    // the clock of the last store or hit, which orders the evictions
+    uint32_t stamp;
+    uint32_t unused;
+} Slot;
+
+static int fd = -1;
+static Header *header = NULL;
+static Slot *slots = NULL;
+static size_t mapped = 0;
+
+static uint64_t mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+static uint64_t hash_string(const char *s, uint64_t seed) {
+    uint64_t h = seed;
+    for (; *s != '\0'; s++) {
+        h = mix(h ^ (unsigned char) *s);
+    }
+    return h;
+}
+
+// never 0, which is the checksum of an empty slot
+static uint32_t checksum(const Slot *slot) {
+    return (uint32_t) mix(slot->h1 ^ mix(slot->h2 ^ slot->verdict)) | 1u;
+}
+
+bool open_verdict_cache(const char *path, char **error) {
+    close_verdict_cache();
+
+    // only a file which is created here, or an empty one, is initialized
+    bool fresh = false;
+    fd = open(path, O_RDWR);
+    if (fd < 0 && errno == ENOENT) {
+        fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+        fresh = fd >= 0;
+    }
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        asprintf(error, "Cannot open the verdict cache '%s'", path);
+        close_verdict_cache();
+        return false;
+    }
+    fresh = fresh || st.st_size == 0;
+
+    // any other file must be a cache of the same format, or it is left as it is
+    size_t size = sizeof(Header) + VERDICT_CACHE_SLOTS * sizeof(Slot);
+    Header h;
+    if (!fresh && ((size_t) st.st_size != size || pread(fd, &h, sizeof(h), 0) != (ssize_t) sizeof(h) ||
+                   h.magic != MAGIC || h.n_slots != VERDICT_CACHE_SLOTS)) {
+        asprintf(error, "'%s' is not a verdict cache", path);
+        close_verdict_cache();
+        return false;
+    }
+    if (fresh && ftruncate(fd, (off_t) size) != 0) {
+        asprintf(error, "Cannot resize the verdict cache '%s'", path);
+        close_verdict_cache();
+        return false;
+    }
+
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        asprintf(error, "Cannot map the verdict cache '%s'", path);
+        close_verdict_cache();
+        return false;
+    }
+    mapped = size;
+    header = (Header *) p;
+    slots = (Slot *) (header + 1);
+    if (fresh) {
+        header->magic = MAGIC;
+        header->n_slots = VERDICT_CACHE_SLOTS;
+    }
+    return true;
+}
+
+void close_verdict_cache() {
+    if (header != NULL) {
+        munmap(header, mapped);
+        header = NULL;
+        slots = NULL;
+        mapped = 0;
+    }
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+// the number of rounds which refine the colors of the atoms
+#define ROUNDS 3
+
+// the state of the canonicalization of an argument
+typedef struct {
+    GString *text;
+    // the shapes of the wffs under the current colors
+    GHashTable *shapes;
+    // the color of every atom, which sums up the places where it occurs, and the next one
+    uint64_t *colors;
+    uint64_t *next;
+    // the new name of every atom, or -1
+    int *names;
+    int n_names;
+} Canonizer;
+
+// the hash of a wff whose atoms are replaced by their colors, which does not depend on the order
+// of the operands of & and |
+static uint64_t shape(Canonizer *c, const Wff *wff) {
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        return c->colors[wff->atom];
+    }
+    uint64_t *known = g_hash_table_lookup(c->shapes, wff);
+    if (known != NULL) {
+        return *known;
+    }
+
+    uint64_t h;
+    if (wff->type == WFF_NEGATION) {
+        h = mix(WFF_NEGATION + mix(shape(c, wff->wff1)));
+    } else {
+        uint64_t a = shape(c, wff->wff1);
+        uint64_t b = shape(c, wff->wff2);
+        if (wff->type != WFF_CONDITIONAL && a > b) {
+            uint64_t t = a;
+            a = b;
+            b = t;
+        }
+        h = mix(wff->type + mix(a + mix(b)));
+    }
+    uint64_t *value = g_new(uint64_t, 1);
+    *value = h;
+    g_hash_table_insert(c->shapes, (gpointer) wff, value);
+    return h;
+}
+
+// adds to the next color of every atom the hash of the context of each of its occurrences, i.e.,
+// of the operators above it, of its side of ->, and of the shapes of its siblings
+static void refine(Canonizer *c, const Wff *wff, uint64_t context) {
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        c->next[wff->atom] += mix(context);
+    } else if (wff->type == WFF_NEGATION) {
+        refine(c, wff->wff1, mix(context + WFF_NEGATION));
+    } else {
+        uint64_t left = wff->type == WFF_CONDITIONAL ? 1 : 0;
+        refine(c, wff->wff1, mix(context + mix(wff->type + left + mix(shape(c, wff->wff2)))));
+        refine(c, wff->wff2, mix(context + mix(wff->type + mix(shape(c, wff->wff1)))));
+    }
+}
+
+static void append_wff(Canonizer *c, const Wff *wff) {
+    if (wff->type == WFF_ATOMIC_CONDITION) {
+        // the atoms are numbered in the order of their first occurrence
+        if (c->names[wff->atom] < 0) {
+            c->names[wff->atom] = c->n_names++;
+        }
+        g_string_append_printf(c->text, "a%d", c->names[wff->atom]);
+        return;
+    }
+    if (wff->type == WFF_NEGATION) {
+        g_string_append_c(c->text, '!');
+        append_wff(c, wff->wff1);
+        return;
+    }
+
+    const Wff *x = wff->wff1;
+    const Wff *y = wff->wff2;
+    if (wff->type != WFF_CONDITIONAL && shape(c, x) > shape(c, y)) {
+        x = wff->wff2;
+        y = wff->wff1;
+    }
+    g_string_append_c(c->text, '(');
+    append_wff(c, x);
+    g_string_append(c->text, wff->type == WFF_CONJUNCTION ? " & " : wff->type == WFF_DISJUNCTION ? " | " : " -> ");
+    append_wff(c, y);
+    g_string_append_c(c->text, ')');
+}
+
+static Canonizer *sorting_canonizer;
+
+static gint compare_shapes(gconstpointer a, gconstpointer b) {
+    uint64_t x = shape(sorting_canonizer, *(const Wff **) a);
+    uint64_t y = shape(sorting_canonizer, *(const Wff **) b);
+    return x < y ? -1 : x > y;
+}
+
+char *canonical_argument(const char *command, const Wff *argument) {
+    int n_atoms = count_atoms();
+    Canonizer c;
+    c.text = g_string_new(command);
+    c.shapes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    c.colors = g_new(uint64_t, n_atoms + 1);
+    c.next = g_new(uint64_t, n_atoms + 1);
+    c.names = g_new(int, n_atoms + 1);
+    c.n_names = 0;
+    for (int i = 0; i < n_atoms; i++) {
+        c.colors[i] = 1;
+        c.names[i] = -1;
+    }
+
+    // the premises are a set
+    GPtrArray *premises = g_ptr_array_new();
+    for (GSList *list = argument->premises; list != NULL; list = list->next) {
+        const Wff *premise = list->data;
+        bool duplicate = false;
+        for (guint j = 0; j < premises->len && !duplicate; j++) {
+            const Wff *other = g_ptr_array_index(premises, j);
+            duplicate = other == premise || (premise->id >= 0 && other->id == premise->id);
+        }
+        if (!duplicate) {
+            g_ptr_array_add(premises, (gpointer) premise);
+        }
+    }
+
+    // the colors tell apart the atoms which play different roles, whatever their names
+    for (int round = 0; round < ROUNDS; round++) {
+        memcpy(c.next, c.colors, n_atoms * sizeof(uint64_t));
+        for (guint i = 0; i < premises->len; i++) {
+            refine(&c, g_ptr_array_index(premises, i), 1);
+        }
+        if (argument->wff1 != NULL) {
+            refine(&c, argument->wff1, 2);
+        }
+        for (int i = 0; i < n_atoms; i++) {
+            c.colors[i] = mix(c.next[i]);
+        }
+        g_hash_table_remove_all(c.shapes);
+    }
+
+    sorting_canonizer = &c;
+    g_ptr_array_sort(premises, compare_shapes);
+    for (guint i = 0; i < premises->len; i++) {
+        if (i > 0) {
+            g_string_append(c.text, ", ");
+        }
+        append_wff(&c, g_ptr_array_index(premises, i));
+    }
+    if (argument->wff1 != NULL) {
+        g_string_append(c.text, "=>");
+        append_wff(&c, argument->wff1);
+    }
+
+    g_ptr_array_free(premises, TRUE);
+    g_free(c.colors);
+    g_free(c.next);
+    g_free(c.names);
+    g_hash_table_destroy(c.shapes);
+    return g_string_free(c.text, FALSE);
+}
+
+// returns the slot of the key, or NULL
+static Slot *find(uint64_t h1, uint64_t h2) {
+    for (uint32_t i = 0; i < WINDOW; i++) {
+        Slot *slot = &slots[(h1 + i) % VERDICT_CACHE_SLOTS];
+        if (slot->h1 == h1 && slot->h2 == h2 && slot->check == checksum(slot)) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+bool lookup_verdict(const char *command, const Wff *argument, bool *verdict) {
+    if (header == NULL) {
+        return false;
+    }
+    char *key = canonical_argument(command, argument);
+    Slot *slot = find(hash_string(key, 0), hash_string(key, 0x9E3779B97F4A7C15ull));
+    g_free(key);
+    if (slot == NULL) {
+        return false;
+    }
+    *verdict = slot->verdict;
+    slot->stamp = ++header->clock;
+    return true;
+}
+
+void store_verdict(const char *command, const Wff *argument, bool verdict) {
+    if (header == NULL) {
+        return;
+    }
+    char *key = canonical_argument(command, argument);
+    uint64_t h1 = hash_string(key, 0);
+    uint64_t h2 = hash_string(key, 0x9E3779B97F4A7C15ull);
+    g_free(key);
+
+    // the key goes in its own slot, or in an empty or torn one, or else in the least recently used
+    Slot *slot = find(h1, h2);
+    for (uint32_t i = 0; slot == NULL && i < WINDOW; i++) {
+        Slot *s = &slots[(h1 + i) % VERDICT_CACHE_SLOTS];
+        if (s->check != checksum(s)) {
+            slot = s;
+        }
+    }
+    if (slot == NULL) {
+        slot = &slots[h1 % VERDICT_CACHE_SLOTS];
+        for (uint32_t i = 1; i < WINDOW; i++) {
+            Slot *s = &slots[(h1 + i) % VERDICT_CACHE_SLOTS];
+            if (s->stamp < slot->stamp) {
+                slot = s;
+            }
+        }
+    }
+
+    // the checksum is cleared first, hence the slot is never valid with a mix of two keys
+    slot->check = 0;
+    slot->h1 = h1;
+    slot->h2 = h2;
+    slot->verdict = verdict;
+    slot->stamp = ++header->clock;
+    slot->check = checksum(slot);
+}
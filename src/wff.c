@@ -3,20 +3,24 @@
  */
 #include <glib.h>
 #include <stdio.h>
+#include "../include/arena.h"
+#include "../include/engine.h"
+#include "../include/symbols.h"
 #include "../include/wff.h"
 #include "../include/token.h"
+#include "../include/unique.h"
 
 // allocate
 
 static Wff *create_wff(WffType type) {
-    Wff *f = malloc(sizeof(Wff));
+    Wff *f = scoped_alloc(sizeof(Wff));
     f->type = type;
     f->wff1 = NULL;
     f->wff2 = NULL;
     f->premises = NULL;
-    f->falsehood_conditions = NULL;
-    f->truth_conditions = NULL;
     f->value = NULL;
+    f->atom = -1;
+    f->id = -1;
     f->b_value = FALSE;
     return f;
 }
@@ -26,8 +30,13 @@ Wff *create_argument() {
 }
 
 Wff *create_atomic_condition(const char *value) {
+    return create_interned_atomic_condition(intern_atom(value));
+}
+
+Wff *create_interned_atomic_condition(int atom) {
     Wff *f = create_wff(WFF_ATOMIC_CONDITION);
-    f->value = strdup(value);
+    f->atom = atom;
+    f->value = (char *) atom_name(atom);
     return f;
 }
 
@@ -70,12 +79,14 @@ Wff *create_negation(Wff *wff1) {
 void free_wff(gpointer data) {
     Wff *wff = (Wff *)data;
 
-    g_free(wff->value);
+    // the wffs allocated from an arena are released with it
+    if (get_arena() != NULL) {
+        return;
+    }
+
     g_free(wff->wff1);
     g_free(wff->wff2);
     g_slist_free(wff->premises);
-    g_slist_free(wff->falsehood_conditions);
-    g_slist_free(wff->truth_conditions);
 
     g_free(wff);
 }
@@ -86,55 +97,74 @@ void add_premise_to_argument(Wff *arg, Wff *premise) {
     arg->premises = g_slist_append(arg->premises, premise);
 }
 
-GSList *determine_falsehood_conditions(Wff *wff) {
+// The conditions of the subformulae are computed once per call, and kept in a table of the call,
+// so that every subformula is visited once per polarity. The wffs themselves are not written,
+// since the ones from the unique table are shared by the threads
+typedef struct {
+    GHashTable *truth;
+    GHashTable *falsehood;
+} Conditions;
+
+static GSList *truth_conditions(Conditions *memo, Wff *wff);
+
+static GSList *falsehood_conditions(Conditions *memo, Wff *wff) {
     if (wff->type == WFF_NEGATION) {
-        return determine_truthness_conditions(wff->wff1);
+        return truth_conditions(memo, wff->wff1);
+    }
+    gpointer known;
+    if (g_hash_table_lookup_extended(memo->falsehood, wff, NULL, &known)) {
+        return (GSList *) known;
     }
 
     GSList *list = NULL;
     if (wff->type == WFF_ATOMIC_CONDITION) {
-        Wff *f = create_atomic_condition(wff->value);
+        Wff *f = create_interned_atomic_condition(wff->atom);
         f->b_value = FALSE;
         list = g_slist_append(list, f);
     } else if (wff->type == WFF_CONDITIONAL) {
-        GSList *wff1_t_conds = determine_truthness_conditions(wff->wff1);
-        GSList *wff2_f_conds = determine_falsehood_conditions(wff->wff2);
+        GSList *wff1_t_conds = truth_conditions(memo, wff->wff1);
+        GSList *wff2_f_conds = falsehood_conditions(memo, wff->wff2);
 
         list = g_slist_append(list, create_binary_condition(wff1_t_conds->data, wff2_f_conds->data));
     } else if (wff->type == WFF_CONJUNCTION) {
-        GSList *wff1_f_conds = determine_falsehood_conditions(wff->wff1);
-        GSList *wff1_t_conds = determine_truthness_conditions(wff->wff1);
-        GSList *wff2_f_conds = determine_falsehood_conditions(wff->wff2);
-        GSList *wff2_t_conds = determine_truthness_conditions(wff->wff2);
+        GSList *wff1_f_conds = falsehood_conditions(memo, wff->wff1);
+        GSList *wff1_t_conds = truth_conditions(memo, wff->wff1);
+        GSList *wff2_f_conds = falsehood_conditions(memo, wff->wff2);
+        GSList *wff2_t_conds = truth_conditions(memo, wff->wff2);
 
         list = g_slist_append(list, create_binary_condition(wff1_f_conds->data, wff2_f_conds->data));
         list = g_slist_append(list, create_binary_condition(wff1_f_conds->data, wff2_t_conds->data));
         list = g_slist_append(list, create_binary_condition(wff1_t_conds->data, wff2_f_conds->data));
     } else if (wff->type == WFF_DISJUNCTION) {
-        GSList *wff1_f_conds = determine_falsehood_conditions(wff->wff1);
-        GSList *wff2_f_conds = determine_falsehood_conditions(wff->wff2);
+        GSList *wff1_f_conds = falsehood_conditions(memo, wff->wff1);
+        GSList *wff2_f_conds = falsehood_conditions(memo, wff->wff2);
 
         list = g_slist_append(list, create_binary_condition(wff1_f_conds->data, wff2_f_conds->data));
     }
+    g_hash_table_insert(memo->falsehood, wff, list);
     return list;
 }
 
-GSList *determine_truthness_conditions(Wff *wff) {
+static GSList *truth_conditions(Conditions *memo, Wff *wff) {
     if (wff->type == WFF_NEGATION) {
-        return determine_falsehood_conditions(wff->wff1);
+        return falsehood_conditions(memo, wff->wff1);
+    }
+    gpointer known;
+    if (g_hash_table_lookup_extended(memo->truth, wff, NULL, &known)) {
+        return (GSList *) known;
     }
 
     GSList *list = NULL;
     if (wff->type == WFF_ATOMIC_CONDITION) {
-        Wff *f = create_atomic_condition(wff->value);
+        Wff *f = create_interned_atomic_condition(wff->atom);
         f->b_value = TRUE;
         list = g_slist_append(list, f);
     } else if (wff->type == WFF_CONDITIONAL) {
-        GSList *wff1_f_conds = determine_falsehood_conditions(wff->wff1);
-        GSList *wff1_t_conds = determine_truthness_conditions(wff->wff1);
+        GSList *wff1_f_conds = falsehood_conditions(memo, wff->wff1);
+        GSList *wff1_t_conds = truth_conditions(memo, wff->wff1);
 
-        GSList *wff2_f_conds = determine_falsehood_conditions(wff->wff2);
-        GSList *wff2_t_conds = determine_truthness_conditions(wff->wff2);
+        GSList *wff2_f_conds = falsehood_conditions(memo, wff->wff2);
+        GSList *wff2_t_conds = truth_conditions(memo, wff->wff2);
 
         if (wff1_f_conds) {
             list = g_slist_append(list, create_binary_condition(wff1_f_conds->data, wff2_f_conds->data));
@@ -142,16 +172,16 @@ GSList *determine_truthness_conditions(Wff *wff) {
             list = g_slist_append(list, create_binary_condition(wff1_t_conds->data, wff2_t_conds->data));
         }
     } else if (wff->type == WFF_CONJUNCTION) {
-        GSList *wff1_t_conds = determine_truthness_conditions(wff->wff1);
-        GSList *wff2_t_conds = determine_truthness_conditions(wff->wff2);
+        GSList *wff1_t_conds = truth_conditions(memo, wff->wff1);
+        GSList *wff2_t_conds = truth_conditions(memo, wff->wff2);
 
         list = g_slist_append(list, create_binary_condition(wff1_t_conds->data, wff2_t_conds->data));
     } else if (wff->type == WFF_DISJUNCTION) {
-        GSList *wff1_f_conds = determine_falsehood_conditions(wff->wff1);
-        GSList *wff1_t_conds = determine_truthness_conditions(wff->wff1);
+        GSList *wff1_f_conds = falsehood_conditions(memo, wff->wff1);
+        GSList *wff1_t_conds = truth_conditions(memo, wff->wff1);
 
-        GSList *wff2_f_conds = determine_falsehood_conditions(wff->wff2);
-        GSList *wff2_t_conds = determine_truthness_conditions(wff->wff2);
+        GSList *wff2_f_conds = falsehood_conditions(memo, wff->wff2);
+        GSList *wff2_t_conds = truth_conditions(memo, wff->wff2);
 
         if (wff1_f_conds) {
             list = g_slist_append(list, create_binary_condition(wff1_t_conds->data, wff2_f_conds->data));
@@ -159,115 +189,77 @@ GSList *determine_truthness_conditions(Wff *wff) {
             list = g_slist_append(list, create_binary_condition(wff1_t_conds->data, wff2_t_conds->data));
         }
     }
+    g_hash_table_insert(memo->truth, wff, list);
     return list;
 }
 
-GSList* generate_truth_table(GHashTable *vars) {
-    GSList *varsList = (GSList *) g_hash_table_get_keys(vars);
-    GSList *result = NULL;
-    size_t n = g_slist_length(varsList);
-    int i = 0;
-    int max = 1 << n;
-    while (n > 0 && i != max) {
-
-        char *bits = malloc(n + 1);
-        bits[n] = '\0';
-        int v = i;
-        for (int j = n - 1; j >= 0; j--) {
-            bits[j] = (v & 1) ? '1' : '0';
-            v >>= 1;
-        }
-
-        GHashTable *map = g_hash_table_new(g_str_hash, g_str_equal);
-        int j = 0;
-        for (GSList *list = varsList; list != NULL; list = list->next, j++) {
-            g_hash_table_insert(map, (char *) list->data, GINT_TO_POINTER(bits[j] == '1'));
+// the lists of the subformulae are released, but for the one which is returned
+static void free_conditions(GHashTable *table, GSList *kept) {
+    GHashTableIter iter;
+    gpointer list;
+    g_hash_table_iter_init(&iter, table);
+    while (g_hash_table_iter_next(&iter, NULL, &list)) {
+        if (list != kept) {
+            g_slist_free((GSList *) list);
         }
-        result = g_slist_append(result, map);
-        i++;
-        free(bits);
     }
-
-    return result;
+    g_hash_table_destroy(table);
 }
 
-GSList *get_atomic_conditions(Wff *wff) {
-    GSList *list = NULL;
-    if (wff->type == WFF_ATOMIC_CONDITION) {
-        list = g_slist_append(list, wff);
-    } else if (wff->type == WFF_BINARY_CONDITION) {
-        list = g_slist_concat(list, get_atomic_conditions(wff->wff1));
-        list = g_slist_concat(list, get_atomic_conditions(wff->wff2));
-    }
+static GSList *determine_conditions(Wff *wff, bool truth) {
+    Conditions memo = {
+            g_hash_table_new(g_direct_hash, g_direct_equal),
+            g_hash_table_new(g_direct_hash, g_direct_equal)
+    };
+    GSList *list = truth ? truth_conditions(&memo, wff) : falsehood_conditions(&memo, wff);
+    free_conditions(memo.truth, list);
+    free_conditions(memo.falsehood, list);
     return list;
 }
 
+GSList *determine_falsehood_conditions(Wff *wff) {
+    return determine_conditions(wff, false);
+}
+
+GSList *determine_truthness_conditions(Wff *wff) {
+    return determine_conditions(wff, true);
+}
+
 bool is_tautology(Wff *argument, char **error) {
     if (argument->type != WFF_ARGUMENT || argument->wff1 != NULL || g_slist_length(argument->premises) != 1) {
         *error = strdup("this method can be only invoked on arguments without conclusion and exactly one premise");
         return FALSE;
     }
 
-    Wff *wff = (Wff *) argument->premises->data;
-    GHashTable* vars = g_hash_table_new(g_str_hash, g_str_equal);
-    for (GSList *clist = determine_truthness_conditions(wff); clist != NULL; clist = clist->next) {
-        for (GSList *alist = get_atomic_conditions((Wff *)clist->data); alist != NULL; alist = alist->next) {
-            g_hash_table_insert(vars, ((Wff *)alist->data)->value, NULL);
-        }
-    }
-
-    for (GSList *list = generate_truth_table(vars); list != NULL; list = list->next) {
-        if (!valuate(wff, ( GHashTable *) list->data, error)) {
-            return false;
-        }
-    }
+    // the wff is a tautology if there is no assignment which makes its negation true
+    Wff negation = {.type = WFF_NEGATION, .wff1 = (Wff *) argument->premises->data, .atom = -1};
+    GSList *formulae = g_slist_append(NULL, &negation);
 
-    return TRUE;
+    bool tautology = !is_satisfiable(formulae, error);
+    g_slist_free(formulae);
+    return tautology;
 }
 
 bool is_valid(Wff *arg, char **error) {
-    GSList *formulae = NULL;
-    formulae = g_slist_append(formulae, create_negation(arg->wff1));
-    formulae = g_slist_concat(formulae, arg->premises);
-
-    GHashTable* vars = g_hash_table_new(g_str_hash, g_str_equal);
-    for (GSList *flist = formulae; flist != NULL; flist = flist->next) {
-        for (GSList *clist = determine_truthness_conditions((Wff *) flist->data); clist != NULL; clist = clist->next) {
-            for (GSList *alist = get_atomic_conditions((Wff *) clist->data); alist != NULL; alist = alist->next) {
-                g_hash_table_insert(vars, ((Wff *) alist->data)->value, NULL);
-            }
-        }
-    }
-
-    // iterate over all possible input variables configurations
-    for (GSList *vlist = generate_truth_table(vars); vlist != NULL; vlist = vlist->next) {
-        bool valid = TRUE;
-        // valuate all formulae for a given input variables configuration
-        for (GSList *flist = formulae; flist != NULL; flist = flist->next) {
-            // if one formula is false, then move on to the next input variables configuration
-            if (!valuate(flist->data, (GHashTable *) vlist->data, error)) {
-                valid = FALSE;
-                break;
-            }
-        }
-        // an input variables configuration which makes the premises and the negated conclusion all true was found
-        if (valid) {
-            return FALSE;
-        }
-    }
-
-    // no configuration was found, hence the argument is valid
-    return TRUE;
+    Wff negation = {.type = WFF_NEGATION, .wff1 = arg->wff1, .atom = -1};
+    GSList *formulae = g_slist_prepend(g_slist_copy(arg->premises), &negation);
+
+    // an assignment which makes the premises and the negated conclusion all true is a counterexample,
+    // if there is no such assignment, then the argument is valid
+    bool valid = !is_satisfiable(formulae, error);
+    g_slist_free(formulae);
+    return valid;
 }
 
-void *parse_binary(GQueue *tokens, char **error) {
+void *parse_binary(TokenCursor *tokens, char **error) {
     Wff *wff1 = (Wff *) parse_wff(tokens, error);
     if (wff1 == NULL) {
         *error = strdup("wff1 is null");
         return NULL;
     }
 
-    Token *t = g_queue_pop_head(tokens);
+    Token t;
+    pop_token(tokens, &t);
 
     Wff *wff2 = (Wff *) parse_wff(tokens, error);
     if (wff2 == NULL) {
@@ -275,38 +267,40 @@ void *parse_binary(GQueue *tokens, char **error) {
         return NULL;
     }
 
-    g_queue_pop_head(tokens);
-    if (t->type == TOKEN_AND) {
-        return create_conjunction(wff1, wff2);
+    pop_token(tokens, NULL);
+    if (t.type == TOKEN_AND) {
+        return unique_binary(WFF_CONJUNCTION, wff1, wff2);
     }
-    if (t->type == TOKEN_OR) {
-        return create_disjunction(wff1, wff2);
+    if (t.type == TOKEN_OR) {
+        return unique_binary(WFF_DISJUNCTION, wff1, wff2);
     }
-    return create_conditional(wff1, wff2);
+    return unique_binary(WFF_CONDITIONAL, wff1, wff2);
 }
 
-Wff *parse_wff(GQueue *tokens, char **error) {
-    Token *token = g_queue_peek_head(tokens);
-    if (token != NULL) {
-        if (token->type == TOKEN_COMMA || token->type == TOKEN_RIGHT_BRACKET || token->type == TOKEN_THEREFORE) {
+Wff *parse_wff(TokenCursor *tokens, char **error) {
+    Token token;
+    bool found = peek_token(tokens, &token);
+    if (found) {
+        if (token.type == TOKEN_COMMA || token.type == TOKEN_RIGHT_BRACKET || token.type == TOKEN_THEREFORE) {
             return NULL;
         }
-        token = g_queue_pop_head(tokens);
-        if (token->type == TOKEN_ATOM) {
-            return create_atomic_condition(token->value);
+        pop_token(tokens, NULL);
+        if (token.type == TOKEN_ATOM) {
+            return unique_atomic_condition(token.atom);
         }
-        if (token->type == TOKEN_NOT) {
-            return create_negation(parse_wff(tokens, error));
+        if (token.type == TOKEN_NOT) {
+            Wff *wff1 = parse_wff(tokens, error);
+            return wff1 != NULL ? unique_negation(wff1) : NULL;
         }
-        if (token->type == TOKEN_LEFT_BRACKET) {
+        if (token.type == TOKEN_LEFT_BRACKET) {
             return parse_binary(tokens, error);
         }
     }
-    *error = strdup(token == NULL ? "null" : token->value);
+    *error = !found ? strdup("null") : strndup(token.text, token.length);
     return NULL;
 }
 
-bool valuate(Wff *wff, GHashTable *values, char **error) {
+bool valuate(Wff *wff, const Valuation *values, char **error) {
     if (wff->type == WFF_ARGUMENT) {
         bool p = TRUE;
         for (GSList *premises = wff->premises; premises != NULL; premises = premises->next) {
@@ -317,11 +311,11 @@ bool valuate(Wff *wff, GHashTable *values, char **error) {
     }
 
     if (wff->type == WFF_ATOMIC_CONDITION) {
-        if (!g_hash_table_contains(values, wff->value)) {
+        if (!has_atom_value(values, wff->atom)) {
             asprintf(error, "Missing symbol %s", wff->value);
             return FALSE;
         }
-        return GPOINTER_TO_INT(g_hash_table_lookup(values, wff->value));
+        return get_atom_value(values, wff->atom);
     }
 
     if (wff->type == WFF_CONDITIONAL) {
@@ -349,7 +343,7 @@ char **gslist_to_strings(GSList *list) {
     char **array = g_new(char*, n + 1);
 
     GSList *l = list;
-    for (int i = 0; i < n; i++, l = l->next) {
+    for (size_t i = 0; i < n; i++, l = l->next) {
         array[i] = wff_to_string((Wff *) l->data);
     }
     array[n] = NULL;
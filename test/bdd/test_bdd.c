@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include "bdd.h"
+#include "pool.h"
+
+#define GREEN   "\x1b[32m"
+#define RED     "\x1b[31m"
+#define RESET   "\x1b[0m"
+
+void test_bdd() {
+    Wff *p = create_atomic_condition("P");
+    Wff *q = create_atomic_condition("Q");
+    Wff *r = create_atomic_condition("R");
+
+    // equal functions are the same edge
+    Bdd pq = bdd_from_wff(create_conjunction(p, q));
+    Bdd qp = bdd_from_wff(create_conjunction(q, p));
+    Bdd de_morgan = bdd_from_wff(create_negation(create_disjunction(create_negation(p), create_negation(q))));
+    if (pq != qp || pq != de_morgan) {
+        printf(RED "✘ Test case 1 failed: (P & Q), (Q & P) and !(!P | !Q) differ\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    // the complement of a function is its complemented edge
+    Bdd not_pq = bdd_from_wff(create_disjunction(create_negation(p), create_negation(q)));
+    if (not_pq != bdd_not(pq)) {
+        printf(RED "✘ Test case 2 failed: !P | !Q is not the complement of P & Q\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+
+    // ((P -> Q) & (Q -> R)) -> (P -> R) is a tautology
+    Bdd syllogism = bdd_from_wff(create_conditional(
+            create_conjunction(create_conditional(p, q), create_conditional(q, r)),
+            create_conditional(p, r)));
+    if (syllogism != BDD_TRUE) {
+        printf(RED "✘ Test case 3 failed: expected the true constant\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 3 passed\n" RESET);
+    }
+
+    // P & !P is the false constant
+    Bdd contradiction = bdd_from_wff(create_conjunction(p, create_negation(p)));
+    if (contradiction != BDD_FALSE) {
+        printf(RED "✘ Test case 4 failed: expected the false constant\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 4 passed\n" RESET);
+    }
+
+    bdd_deref(pq);
+    bdd_deref(qp);
+    bdd_deref(de_morgan);
+    bdd_deref(not_pq);
+    bdd_deref(syllogism);
+    bdd_deref(contradiction);
+}
+
+void test_bdd_gc() {
+    // thanks to the complement edges, the parity of 16 atoms has one node per atom
+    const int n_atoms = 16;
+    Wff *parity = NULL;
+    for (int i = 0; i < n_atoms; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "X%d", i + 1);
+        Wff *x = create_atomic_condition(name);
+        parity = parity == NULL ? x : create_disjunction(create_conjunction(parity, create_negation(x)),
+                                                         create_conjunction(create_negation(parity), x));
+    }
+
+    bdd_gc();
+    size_t before = bdd_node_count();
+    Bdd f = bdd_from_wff(parity);
+    bdd_gc();
+    size_t after = bdd_node_count();
+    if (after - before != n_atoms) {
+        printf(RED "✘ Test case 1 failed: expected %d nodes, got %zu\n" RESET, n_atoms, after - before);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    bdd_deref(f);
+    bdd_gc();
+    if (bdd_node_count() != before) {
+        printf(RED "✘ Test case 2 failed: expected %zu nodes, got %zu\n" RESET, before, bdd_node_count());
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+}
+
+typedef struct BddJob {
+    Wff *wff;
+    Bdd f;
+    size_t before;
+    size_t after;
+    // the job which ran before on the same thread, whose BDD is released
+    struct BddJob *previous;
+} BddJob;
+
+static void run_bdd_job(gpointer data) {
+    BddJob *job = (BddJob *) data;
+    job->before = bdd_node_count();
+    job->f = bdd_from_wff(job->wff);
+    job->after = bdd_node_count();
+    if (job->previous != NULL) {
+        bdd_deref(job->previous->f);
+        bdd_deref(job->f);
+    }
+}
+
+void test_bdd_pool() {
+    Wff *p = create_atomic_condition("P");
+    Wff *q = create_atomic_condition("Q");
+    Wff *r = create_atomic_condition("R");
+    Wff *wff = create_conjunction(create_disjunction(p, q), create_conditional(q, r));
+
+    // the jobs of a thread share its nodes, hence the second job finds those of the first one
+    Pool *pool = create_pool(1, run_bdd_job);
+    BddJob first = {.wff = wff, .previous = NULL};
+    BddJob second = {.wff = wff, .previous = &first};
+    submit_job(pool, &first);
+    wait_job(pool, submit_job(pool, &second));
+    free_pool(pool);
+
+    if (first.after <= 1 || second.before != first.after) {
+        printf(RED "✘ Test case 1 failed: the second job began with %zu nodes, not %zu\n" RESET,
+               second.before, first.after);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    if (second.f != first.f || second.after != first.after) {
+        printf(RED "✘ Test case 2 failed: the second job built its BDD again\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+}
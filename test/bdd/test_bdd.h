@@ -0,0 +1,10 @@
+#ifndef ARIS_PL_TEST_BDD_H
+#define ARIS_PL_TEST_BDD_H
+
+void test_bdd();
+
+void test_bdd_gc();
+
+void test_bdd_pool();
+
+#endif //ARIS_PL_TEST_BDD_H
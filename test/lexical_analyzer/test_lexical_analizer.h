@@ -5,4 +5,12 @@ void test_tokenize();
 
 void test_tokenize_fails();
 
+void test_tokenize_keywords();
+
+void test_tokenize_kernels();
+
+void test_tokenize_arena();
+
+void test_tokenize_source();
+
 #endif //ARIS_PL_TEST_LEXICAL_ANALIZER_H
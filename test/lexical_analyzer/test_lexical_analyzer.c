@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
+#include "arena.h"
 #include "lexical_analyzer.h"
+#include "scan.h"
 #include "token.h"
 
 #define GREEN   "\x1b[32m"
@@ -9,7 +11,7 @@
 
 typedef struct {
     const char *line;
-    Token **tokens;
+    Token *tokens;
     size_t n_tokens;
 } TestCase;
 
@@ -63,6 +65,12 @@ const char *token_type_to_str(TokenType type) {
     }
 }
 
+// a token of the type, whose text is the given one
+static Token expect(TokenType type, const char *text) {
+    Token token = {type, text, strlen(text), -1};
+    return token;
+}
+
 void test_tokenize() {
     const int num_tests = 12;
 
@@ -73,16 +81,16 @@ void test_tokenize() {
 
     test_cases[i].line = "print \"Hello, Aris!\"";
     test_cases[i].n_tokens = 2;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_print_token();
-    test_cases[i].tokens[j] = create_string_token("Hello, Aris!");
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_PRINT, "print");
+    test_cases[i].tokens[j] = expect(TOKEN_STRING, "Hello, Aris!");
 
     i++;
     j = 0;
     test_cases[i].line = "print\n";
     test_cases[i].n_tokens = 1;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j] = create_print_token();
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j] = expect(TOKEN_PRINT, "print");
 
     i++;
     test_cases[i].line = "// here we go!";
@@ -93,179 +101,175 @@ void test_tokenize() {
     j = 0;
     test_cases[i].line = "P := \t true\n";
     test_cases[i].n_tokens = 3;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_assign_token();
-    test_cases[i].tokens[j] = create_true_token();
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSIGN, ":=");
+    test_cases[i].tokens[j] = expect(TOKEN_TRUE, "true");
 
     i++;
     j = 0;
     test_cases[i].line = " Q := true\n";
     test_cases[i].n_tokens = 3;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_atom_token("Q");
-    test_cases[i].tokens[j++] = create_assign_token();
-    test_cases[i].tokens[j] = create_true_token();
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "Q");
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSIGN, ":=");
+    test_cases[i].tokens[j] = expect(TOKEN_TRUE, "true");
 
     i++;
     j = 0;
     test_cases[i].line = "R := true\n";
     test_cases[i].n_tokens = 3;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_atom_token("R");
-    test_cases[i].tokens[j++] = create_assign_token();
-    test_cases[i].tokens[j] = create_true_token();
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "R");
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSIGN, ":=");
+    test_cases[i].tokens[j] = expect(TOKEN_TRUE, "true");
 
     i++;
     j = 0;
     test_cases[i].line = "argument arg1 := (P & Q) => R\n";
     test_cases[i].n_tokens = 10;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_argument_token();
-    test_cases[i].tokens[j++] = create_identifier_token("arg1");
-    test_cases[i].tokens[j++] = create_assign_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_and_token();
-    test_cases[i].tokens[j++] = create_atom_token("Q");
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j++] = create_therefore_token();
-    test_cases[i].tokens[j] = create_atom_token("R");
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ARGUMENT, "argument");
+    test_cases[i].tokens[j++] = expect(TOKEN_IDENTIFIER, "arg1");
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSIGN, ":=");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_AND, "&");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "Q");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j++] = expect(TOKEN_THEREFORE, "=>");
+    test_cases[i].tokens[j] = expect(TOKEN_ATOM, "R");
 
     i++;
     j = 0;
     test_cases[i].line = "valuate arg1\n";
     test_cases[i].n_tokens = 2;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_valuate_token();
-    test_cases[i].tokens[j] = create_identifier_token("arg1");
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_VALUATE, "valuate");
+    test_cases[i].tokens[j] = expect(TOKEN_IDENTIFIER, "arg1");
 
     i++;
     j = 0;
     test_cases[i].line = "argument arg2 := P, !(P & !Q) => Q\n";
     test_cases[i].n_tokens = 14;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_argument_token();
-    test_cases[i].tokens[j++] = create_identifier_token("arg2");
-    test_cases[i].tokens[j++] = create_assign_token();
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_comma_token();
-    test_cases[i].tokens[j++] = create_not_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_and_token();
-    test_cases[i].tokens[j++] = create_not_token();
-    test_cases[i].tokens[j++] = create_atom_token("Q");
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j++] = create_therefore_token();
-    test_cases[i].tokens[j] = create_atom_token("Q");
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ARGUMENT, "argument");
+    test_cases[i].tokens[j++] = expect(TOKEN_IDENTIFIER, "arg2");
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSIGN, ":=");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_COMMA, ",");
+    test_cases[i].tokens[j++] = expect(TOKEN_NOT, "!");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_AND, "&");
+    test_cases[i].tokens[j++] = expect(TOKEN_NOT, "!");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "Q");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j++] = expect(TOKEN_THEREFORE, "=>");
+    test_cases[i].tokens[j] = expect(TOKEN_ATOM, "Q");
 
     i++;
     j = 0;
     test_cases[i].line = "validate arg2\n";
     test_cases[i].n_tokens = 2;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_validate_token();
-    test_cases[i].tokens[j] = create_identifier_token("arg2");
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_VALIDATE, "validate");
+    test_cases[i].tokens[j] = expect(TOKEN_IDENTIFIER, "arg2");
 
     i++;
     j = 0;
     test_cases[i].line = "argument arg3 := (!(!(P & Q) & !(P & R)) | !(P & (Q | R)))\n";
     test_cases[i].n_tokens = 32;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_argument_token();
-    test_cases[i].tokens[j++] = create_identifier_token("arg3");
-    test_cases[i].tokens[j++] = create_assign_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_not_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_not_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_and_token();
-    test_cases[i].tokens[j++] = create_atom_token("Q");
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j++] = create_and_token();
-    test_cases[i].tokens[j++] = create_not_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_and_token();
-    test_cases[i].tokens[j++] = create_atom_token("R");
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j++] = create_or_token();
-    test_cases[i].tokens[j++] = create_not_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_atom_token("P");
-    test_cases[i].tokens[j++] = create_and_token();
-    test_cases[i].tokens[j++] = create_left_bracket_token();
-    test_cases[i].tokens[j++] = create_atom_token("Q");
-    test_cases[i].tokens[j++] = create_or_token();
-    test_cases[i].tokens[j++] = create_atom_token("R");
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j++] = create_right_bracket_token();
-    test_cases[i].tokens[j] = create_right_bracket_token();
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ARGUMENT, "argument");
+    test_cases[i].tokens[j++] = expect(TOKEN_IDENTIFIER, "arg3");
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSIGN, ":=");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_NOT, "!");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_NOT, "!");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_AND, "&");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "Q");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j++] = expect(TOKEN_AND, "&");
+    test_cases[i].tokens[j++] = expect(TOKEN_NOT, "!");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_AND, "&");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "R");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j++] = expect(TOKEN_OR, "|");
+    test_cases[i].tokens[j++] = expect(TOKEN_NOT, "!");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "P");
+    test_cases[i].tokens[j++] = expect(TOKEN_AND, "&");
+    test_cases[i].tokens[j++] = expect(TOKEN_LEFT_BRACKET, "(");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "Q");
+    test_cases[i].tokens[j++] = expect(TOKEN_OR, "|");
+    test_cases[i].tokens[j++] = expect(TOKEN_ATOM, "R");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j++] = expect(TOKEN_RIGHT_BRACKET, ")");
+    test_cases[i].tokens[j] = expect(TOKEN_RIGHT_BRACKET, ")");
 
     i++;
     j = 0;
     test_cases[i].line = "assert arg3\n";
     test_cases[i].n_tokens = 2;
-    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token *));
-    test_cases[i].tokens[j++] = create_assert_token();
-    test_cases[i].tokens[j] = create_identifier_token("arg3");
+    test_cases[i].tokens = malloc(test_cases[i].n_tokens * sizeof(Token));
+    test_cases[i].tokens[j++] = expect(TOKEN_ASSERT, "assert");
+    test_cases[i].tokens[j] = expect(TOKEN_IDENTIFIER, "arg3");
 
     for (i = 0; i < num_tests; i++) {
         char *error = NULL;
-        GQueue *all_tokens = tokenize_string(test_cases[i].line, &error);
+        TokenStream *stream = tokenize_string(test_cases[i].line, &error);
 
         if (error) {
             printf(RED "✘ Test case %d failed: %s\n" RESET, i + 1, error);
             free(error);
             continue;
         }
-        if (all_tokens == NULL) {
+        if (stream->n_statements == 0) {
             if (test_cases[i].n_tokens == 0) {
                 printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
             } else {
-                printf(RED "✘ Test case %d failed: expected %zu tokens, got NULL\n" RESET,
-                       i + 1, test_cases[i].n_tokens);
-            }
-            continue;
-        }
-
-        GQueue *tokens = g_queue_pop_head(all_tokens);
-        if (tokens == NULL) {
-            if (test_cases[i].tokens != NULL) {
-                printf(RED "✘ Test case %d failed: expected %zu tokens, got NULL\n" RESET,
+                printf(RED "✘ Test case %d failed: expected %zu tokens, got none\n" RESET,
                        i + 1, test_cases[i].n_tokens);
             }
+            free_token_stream(stream);
             continue;
         }
 
-        guint n = g_queue_get_length(tokens);
+        TokenCursor tokens = statement_cursor(stream, 0);
+        size_t n = tokens.end - tokens.next;
         if (n != test_cases[i].n_tokens) {
-            printf(RED "✘ Test case %d failed: expected %zu tokens, got %d\n" RESET,
+            printf(RED "✘ Test case %d failed: expected %zu tokens, got %zu\n" RESET,
                    i + 1, test_cases[i].n_tokens, n);
+            free_token_stream(stream);
             continue;
         }
 
         j = 0;
         bool failed = false;
-        for (Token *token; (token = (Token *) g_queue_pop_head(tokens)) != NULL; j++) {
-            if (test_cases[i].tokens[j]->type != token->type) {
+        for (Token token; pop_token(&tokens, &token); j++) {
+            Token *expected = &test_cases[i].tokens[j];
+            if (expected->type != token.type) {
                 printf(RED "✘ Test case %d failed: wrong token's type - expected %s got %s\n" RESET,
-                       i + 1, token_type_to_str(test_cases[i].tokens[j]->type),
-                       token_type_to_str(token->type));
+                       i + 1, token_type_to_str(expected->type),
+                       token_type_to_str(token.type));
                 failed = true;
                 break;
             }
-            if (strcmp(test_cases[i].tokens[j]->value, token->value) != 0) {
-                printf(RED "✘ Test case %d failed: wrong token's value - expected %s, got %s\n" RESET,
-                       i + 1, test_cases[i].tokens[j]->value, token->value);
+            if (expected->length != token.length || memcmp(expected->text, token.text, token.length) != 0) {
+                printf(RED "✘ Test case %d failed: wrong token's text - expected %.*s, got %.*s\n" RESET,
+                       i + 1, (int) expected->length, expected->text, (int) token.length, token.text);
                 failed = true;
                 break;
             }
         }
+        free_token_stream(stream);
         if (failed) continue;
 
         printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
@@ -330,7 +334,7 @@ void test_tokenize_fails() {
         char *error = NULL;
 
         FailedTestCase *tc = &test_cases[i];
-        GQueue *tokens = tokenize_string(tc->line, &error);
+        TokenStream *tokens = tokenize_string(tc->line, &error);
 
         if (tokens != NULL) {
             printf(RED "✘ Test case %zu failed: expected NULL\n" RESET, i + 1);
@@ -346,3 +350,179 @@ void test_tokenize_fails() {
         printf(GREEN "✔ Test case %zu passed\n" RESET, i + 1);
     }
 }
+
+void test_tokenize_arena() {
+    Arena *arena = create_arena();
+    set_arena(arena);
+
+    char *error = NULL;
+    TokenStream *stream = tokenize_string("argument a := (P & Q) => R\n", &error);
+    const char *expected[] = {"argument", "a", ":=", "(", "P", "&", "Q", ")", "=>", "R"};
+
+    if (error || stream == NULL || stream->n_statements != 1 || stream->n_tokens != 10) {
+        printf(RED "✘ Test case 1 failed: expected 10 tokens\n" RESET);
+    } else {
+        bool failed = false;
+        TokenCursor tokens = statement_cursor(stream, 0);
+        for (int i = 0; i < 10 && !failed; i++) {
+            Token token;
+            pop_token(&tokens, &token);
+            if (strlen(expected[i]) != token.length || memcmp(expected[i], token.text, token.length) != 0) {
+                printf(RED "✘ Test case 1 failed: expected %s, got %.*s\n" RESET, expected[i], (int) token.length, token.text);
+                failed = true;
+            }
+        }
+        if (!failed) {
+            printf(GREEN "✔ Test case 1 passed\n" RESET);
+        }
+    }
+
+    // the tokens live in the arrays of the stream, hence the arena is left to the wffs
+    size_t used = arena_bytes_used(arena);
+    if (used != 0) {
+        printf(RED "✘ Test case 2 failed: %zu bytes used by the tokens\n" RESET, used);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    if (stream != NULL) {
+        free_token_stream(stream);
+    }
+
+    free_arena(arena);
+    if (get_arena() != NULL) {
+        printf(RED "✘ Test case 3 failed: the arena is still in use\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 3 passed\n" RESET);
+    }
+}
+
+void test_tokenize_keywords() {
+    // a word is a keyword only if the whole word is, hence the words which begin with a keyword are
+    // identifiers
+    const char *lines[] = {"argument counter := P => Q\n", "validate validated\n", "count truex\n"};
+    const TokenType expected[] = {TOKEN_ARGUMENT, TOKEN_VALIDATE, TOKEN_COUNT};
+    const char *names[] = {"counter", "validated", "truex"};
+    for (int i = 0; i < 3; i++) {
+        char *error = NULL;
+        TokenStream *stream = tokenize_string(lines[i], &error);
+        if (stream == NULL) {
+            printf(RED "✘ Test case %d failed: %s\n" RESET, i + 1, error);
+            continue;
+        }
+        TokenCursor tokens = statement_cursor(stream, 0);
+        Token keyword, name;
+        pop_token(&tokens, &keyword);
+        pop_token(&tokens, &name);
+        if (keyword.type != expected[i] || name.type != TOKEN_IDENTIFIER ||
+            name.length != strlen(names[i]) || memcmp(name.text, names[i], name.length) != 0) {
+            printf(RED "✘ Test case %d failed: wrong tokens\n" RESET, i + 1);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+        free_token_stream(stream);
+    }
+}
+
+// the types and the texts of the tokens of all the lines, one line per row
+static GString *describe_tokens(TokenStream *stream) {
+    GString *description = g_string_new(NULL);
+    for (size_t i = 0; i < stream->n_statements; i++) {
+        TokenCursor tokens = statement_cursor(stream, i);
+        for (Token token; pop_token(&tokens, &token);) {
+            g_string_append_printf(description, "%d:%.*s ", token.type, (int) token.length, token.text);
+        }
+        g_string_append_c(description, '\n');
+    }
+    free_token_stream(stream);
+    return description;
+}
+
+void test_tokenize_kernels() {
+    // the runs of spaces, atoms, words and strings, and the comments, straddle the vectors at
+    // every offset, and the last line has no newline
+    GString *script = g_string_new(NULL);
+    for (int i = 0; i < 70; i++) {
+        g_string_append_printf(script, "%*sargument %.*s := (P%.*s & Q) => R // (P\n", i, "", i + 1,
+                               "abcdefghijklmnopqrstuvwxyz_0123456789abcdefghijklmnopqrstuvwxyz_0123456789", i,
+                               "ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789'ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789'");
+        g_string_append_printf(script, "print \"%*s/ a / b\"%*s//\n", i, "", i, "");
+    }
+    g_string_append(script, "validate a");
+
+    ScanKernel current = get_scan_kernel();
+    set_scan_kernel(SCAN_SCALAR);
+    char *error = NULL;
+    TokenStream *stream = tokenize_string(script->str, &error);
+    if (stream == NULL) {
+        printf(RED "✘ Test case 1 failed: %s\n" RESET, error);
+        set_scan_kernel(current);
+        return;
+    }
+    GString *expected = describe_tokens(stream);
+
+    const ScanKernel kernels[] = {SCAN_SSE42, SCAN_AVX2};
+    const char *names[] = {"SSE4.2", "AVX2"};
+    for (int i = 0; i < 2; i++) {
+        if (!set_scan_kernel(kernels[i])) {
+            printf("Test case %d skipped: %s is not supported\n", i + 1, names[i]);
+            continue;
+        }
+        stream = tokenize_string(script->str, &error);
+        GString *description = stream != NULL ? describe_tokens(stream) : NULL;
+        if (error || description == NULL || strcmp(description->str, expected->str) != 0) {
+            printf(RED "✘ Test case %d failed: the %s tokens differ\n" RESET, i + 1, names[i]);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+        if (description != NULL) {
+            g_string_free(description, TRUE);
+        }
+    }
+
+    set_scan_kernel(current);
+    g_string_free(expected, TRUE);
+    g_string_free(script, TRUE);
+}
+
+void test_tokenize_source() {
+    // a line of 20000 premises, far longer than the lines which fgets used to read
+    const int n_premises = 20000;
+    FILE *file = tmpfile();
+    fputs("argument a := P0", file);
+    for (int i = 1; i < n_premises; i++) {
+        fprintf(file, ", P%d", i);
+    }
+    fputs(" => Q\nvalidate a\n", file);
+    fflush(file);
+    rewind(file);
+
+    char *error = NULL;
+    Source *source = open_source(file, &error);
+    fclose(file);
+    TokenStream *stream = source != NULL ? tokenize(source->text, source->length, &error) : NULL;
+    // argument, a, :=, the premises and their commas, =>, Q
+    size_t expected = 3 + 2 * n_premises - 1 + 2;
+    if (error || stream == NULL || stream->n_statements != 2 || stream->statements[1] != expected) {
+        printf(RED "✘ Test case 1 failed: %s\n" RESET, error ? error : "wrong number of tokens");
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    // the identifiers point into the mapped file
+    Token name = {0};
+    if (stream != NULL && stream->n_tokens > 1) {
+        name = get_token(stream, 1);
+    }
+    if (source == NULL || !source->mapped || name.text == NULL || name.text < source->text ||
+        name.text >= source->text + source->length || name.length != 1 || *name.text != 'a') {
+        printf(RED "✘ Test case 2 failed: the identifier is not a span of the file\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    if (stream != NULL) {
+        free_token_stream(stream);
+    }
+    if (source != NULL) {
+        free_source(source);
+    }
+}
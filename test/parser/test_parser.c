@@ -1,7 +1,21 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include "counter.h"
+#include "dimacs.h"
+#include "engine.h"
+#include "evaluator.h"
+#include "jit.h"
+#include "lexical_analyzer.h"
 #include "parser.h"
+#include "program.h"
+#include "simplify.h"
+#include "sweep.h"
 #include "token.h"
+#include "truth_table.h"
+#include "unique.h"
+#include "verdict_cache.h"
 
 #define GREEN   "\x1b[32m"
 #define RED     "\x1b[31m"
@@ -22,7 +36,7 @@ typedef struct {
 // a test case to be executed in test_valuation method
 typedef struct {
     Wff *wff;
-    GHashTable *values;
+    Valuation *values;
     bool result;
 } VTestCase;
 
@@ -213,41 +227,359 @@ void test_determine_truth_conditions() {
     }
 }
 
+// tokenizes and parses the wff of a line like "argument a := <wff>"
+static Wff *parse_string(const char *str) {
+    char *error = NULL;
+    TokenStream *stream = tokenize_string(str, &error);
+    TokenCursor tokens = statement_cursor(stream, 0);
+    for (int i = 0; i < 3; i++) {
+        pop_token(&tokens, NULL);
+    }
+    Wff *wff = parse_wff(&tokens, &error);
+    free_token_stream(stream);
+    return wff;
+}
+
+// builds the argument of the premises and the conclusion, which are lines like "argument a := <wff>"
+static Wff *parse_argument(const char **premises, int n, const char *conclusion) {
+    Wff *argument = create_argument();
+    for (int i = 0; i < n; i++) {
+        add_premise_to_argument(argument, parse_string(premises[i]));
+    }
+    argument->wff1 = parse_string(conclusion);
+    return argument;
+}
+
+// 6 chains of 12 atoms, i.e., Ci_0 -> Ci_1, ..., Ci_10 -> Ci_11, which share no atoms
+static Wff *create_chains(bool first_premise) {
+    char name[16];
+    Wff *argument = create_argument();
+    for (int i = 0; i < 6; i++) {
+        snprintf(name, sizeof(name), "C%d_0", i);
+        Wff *previous = create_atomic_condition(name);
+        if (first_premise || i > 0) {
+            add_premise_to_argument(argument, previous);
+        }
+        for (int j = 1; j < 12; j++) {
+            snprintf(name, sizeof(name), "C%d_%d", i, j);
+            Wff *next = create_atomic_condition(name);
+            add_premise_to_argument(argument, create_conditional(previous, next));
+            previous = next;
+            if (i == 0 && j == 11) {
+                argument->wff1 = next;
+            }
+        }
+    }
+    return argument;
+}
+
+void test_components() {
+    // the 72 atoms are too many for the truth table, but each chain has 12 of them
+    set_engine(ENGINE_TRUTH_TABLE);
+    bool expected[] = {TRUE, FALSE};
+    for (int i = 0; i < 2; i++) {
+        char *error = NULL;
+        bool valid = is_valid(create_chains(expected[i]), &error);
+        if (error != NULL || valid != expected[i]) {
+            printf(RED "✘ Test case %d failed: expected %s, got %s\n" RESET, i + 1,
+                   expected[i] ? "valid" : "invalid", error != NULL ? error : valid ? "valid" : "invalid");
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+    }
+    set_engine(ENGINE_AUTO);
+}
+
+void test_count() {
+    const char *p[] = {"argument a := (P -> (Q | !R))\n", "argument a := !(S & (R -> Q))\n"};
+    Wff *argument = parse_argument(p, 2, "argument a := ((P | Q) & (!R -> (P & S)))\n");
+    int atoms[] = {intern_atom("P"), intern_atom("Q"), intern_atom("R"), intern_atom("S")};
+
+    // the counts are those of the truth table
+    int models = 0;
+    int counterexamples = 0;
+    for (int bits = 0; bits < 16; bits++) {
+        Valuation *values = create_valuation();
+        for (int i = 0; i < 4; i++) {
+            set_atom_value(values, atoms[i], (bits >> i) & 1);
+        }
+        char *error = NULL;
+        bool premises = true;
+        for (GSList *list = argument->premises; list != NULL; list = list->next) {
+            premises = premises && valuate((Wff *) list->data, values, &error);
+        }
+        models += premises;
+        counterexamples += premises && !valuate(argument->wff1, values, &error);
+        free_valuation(values);
+    }
+    char *m;
+    char *c;
+    int n_atoms;
+    count_argument(argument, &m, &c, &n_atoms);
+    if (atoi(m) != models || atoi(c) != counterexamples || n_atoms != 4) {
+        printf(RED "✘ Test case 1 failed: expected %d, %d got %s, %s\n" RESET, models, counterexamples, m, c);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+    g_free(m);
+    g_free(c);
+
+    // the chains are independent: the first one has 13 models, and the others one each
+    count_argument(create_chains(FALSE), &m, &c, &n_atoms);
+    if (strcmp(m, "13") != 0 || strcmp(c, "1") != 0 || n_atoms != 72) {
+        printf(RED "✘ Test case 2 failed: got %s, %s over %d atoms\n" RESET, m, c, n_atoms);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    g_free(m);
+    g_free(c);
+
+    // 60 disjunctions of two atoms have 3^60 models, which overflow 64 bits
+    char name[16];
+    Wff *disjunctions = create_argument();
+    for (int i = 0; i < 60; i++) {
+        snprintf(name, sizeof(name), "A%d", i);
+        Wff *a = create_atomic_condition(name);
+        snprintf(name, sizeof(name), "B%d", i);
+        add_premise_to_argument(disjunctions, create_disjunction(a, create_atomic_condition(name)));
+        if (i == 0) {
+            disjunctions->wff1 = a;
+        }
+    }
+    count_argument(disjunctions, &m, &c, &n_atoms);
+    if (strcmp(m, "42391158275216203514294433201") != 0 || strcmp(c, "14130386091738734504764811067") != 0) {
+        printf(RED "✘ Test case 3 failed: got %s, %s\n" RESET, m, c);
+    } else {
+        printf(GREEN "✔ Test case 3 passed\n" RESET);
+    }
+    g_free(m);
+    g_free(c);
+
+    // a tautology has no conclusion to falsify
+    const char *t[] = {"argument t := (P | !P)\n"};
+    Wff *tautology = create_argument();
+    add_premise_to_argument(tautology, parse_string(t[0]));
+    count_argument(tautology, &m, &c, &n_atoms);
+    if (strcmp(m, "2") != 0 || c != NULL || n_atoms != 1) {
+        printf(RED "✘ Test case 4 failed: got %s\n" RESET, m);
+    } else {
+        printf(GREEN "✔ Test case 4 passed\n" RESET);
+    }
+    g_free(m);
+}
+
+void test_dimacs() {
+    // an argument is valid if its export is unsatisfiable
+    const char *p[] = {"argument a := (P -> Q)\n", "argument a := (Q -> R)\n"};
+    Wff *arguments[] = {parse_argument(p, 2, "argument a := (P -> R)\n"),
+                        parse_argument(p, 2, "argument a := (R -> P)\n")};
+    for (int i = 0; i < 2; i++) {
+        char *text;
+        size_t size;
+        FILE *out = open_memstream(&text, &size);
+        write_dimacs(out, arguments[i]);
+        fclose(out);
+
+        FILE *in = fmemopen(text, size, "r");
+        char *error = NULL;
+        Wff *cnf = read_dimacs(in, &error);
+        fclose(in);
+        bool satisfiable = cnf != NULL && is_satisfiable(cnf->premises, &error);
+        if (error != NULL || satisfiable != (i == 1) || strstr(text, "c atom 1 P\n") == NULL) {
+            printf(RED "✘ Test case %d failed: got '%s'\n" RESET, i + 1, text);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+        free(text);
+    }
+
+    // the atoms keep their names, the others are named after their variables, and the clauses
+    // may span several lines
+    const char *text = "c atom 2 Q\np cnf 3 2\n1 -2\n 0 3 0\n";
+    FILE *in = fmemopen((void *) text, strlen(text), "r");
+    char *error = NULL;
+    Wff *cnf = read_dimacs(in, &error);
+    fclose(in);
+    if (cnf == NULL || g_slist_length(cnf->premises) != 2 ||
+        strcmp(wff_to_string(cnf->premises->data), "(X1 | !Q)") != 0) {
+        printf(RED "✘ Test case 3 failed: got '%s'\n" RESET, cnf ? wff_to_string(cnf->premises->data) : error);
+    } else {
+        printf(GREEN "✔ Test case 3 passed\n" RESET);
+    }
+
+    text = "p cnf 2 1\n1 -2\n";
+    in = fmemopen((void *) text, strlen(text), "r");
+    cnf = read_dimacs(in, &error);
+    fclose(in);
+    if (cnf != NULL || error == NULL) {
+        printf(RED "✘ Test case 4 failed: the unterminated clause was read\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 4 passed\n" RESET);
+    }
+    free(error);
+
+    // the literals beyond the variables of the header, or beyond int, and the clauses which are not
+    // as many as the header declares, are refused
+    const char *malformed[] = {"p cnf 2 1\n1 -3 0\n", "p cnf 2 1\n1 4294967297 0\n", "p cnf 2 2\n1 -2 0\n",
+                               "p cnf 2 1\n1 0\n2 0\n", "p cnf 2\n1 0\n"};
+    for (int i = 0; i < 5; i++) {
+        error = NULL;
+        in = fmemopen((void *) malformed[i], strlen(malformed[i]), "r");
+        cnf = read_dimacs(in, &error);
+        fclose(in);
+        if (cnf != NULL || error == NULL) {
+            printf(RED "✘ Test case %d failed: '%s' was read\n" RESET, i + 5, malformed[i]);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 5);
+        }
+        free(error);
+    }
+}
+
+// runs the script with the threads, and returns what it printed
+static char *run_script(const char *script, int threads) {
+    char *error = NULL;
+    TokenStream *stream = tokenize_string(script, &error);
+    int current = get_sweep_threads();
+    set_sweep_threads(threads);
+
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    FILE *out = tmpfile();
+    dup2(fileno(out), STDOUT_FILENO);
+    parse(stream);
+    free_token_stream(stream);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    set_sweep_threads(current);
+
+    long size = ftell(out);
+    char *text = calloc(size + 1, 1);
+    rewind(out);
+    fread(text, 1, size, out);
+    fclose(out);
+    return text;
+}
+
+void test_load_dimacs() {
+    // a script names the clauses of a DIMACS file as an argument, which is valid if they are unsatisfiable
+    const char *cnfs[] = {"c atom 1 P\np cnf 2 3\n1 0\n-1 2 0\n-2 0\n", "p cnf 2 2\n1 0\n-1 2 0\n"};
+    const char *verdicts[] = {"is valid\n", "is invalid\n"};
+    for (int i = 0; i < 2; i++) {
+        char path[] = "/tmp/aris_dimacs_XXXXXX";
+        int fd = mkstemp(path);
+        FILE *file = fdopen(fd, "w");
+        fputs(cnfs[i], file);
+        fclose(file);
+
+        char *script;
+        asprintf(&script, "argument a := \"%s\"\nvalidate a\n", path);
+        char *text = run_script(script, 1);
+        unlink(path);
+        if (strstr(text, verdicts[i]) == NULL || (i == 0 && strstr(text, "X1") != NULL)) {
+            printf(RED "✘ Test case %d failed: got '%s'\n" RESET, i + 1, text);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+        free(text);
+        free(script);
+    }
+
+    // a file which does not exist is an error, and the script stops
+    char *text = run_script("argument a := \"/nonexistent/aris.cnf\"\nprint \"after\"\n", 1);
+    if (strstr(text, "after") != NULL) {
+        printf(RED "✘ Test case 3 failed: got '%s'\n" RESET, text);
+    } else {
+        printf(GREEN "✔ Test case 3 passed\n" RESET);
+    }
+    free(text);
+}
+
+void test_parallel_statements() {
+    // the decisions of each argument, whose name is redefined halfway, between lines of the others
+    GString *script = g_string_new(NULL);
+    for (int i = 0; i < 40; i++) {
+        g_string_append_printf(script, "argument a := (P%d -> Q%d), P%d => Q%d\n", i, i, i, i);
+        g_string_append(script, "validate a\nprint \"between\"\n");
+        g_string_append_printf(script, "argument a := (P%d | Q%d) => P%d\n", i, i, i);
+        g_string_append(script, "validate a\ncount a\n");
+        g_string_append_printf(script, "argument t := (P%d | !P%d)\nassert t\n", i, i);
+        g_string_append_printf(script, "P%d := true\nQ%d := false\nvaluate a\n", i, i);
+    }
+    g_string_append(script, "export a\n");
+
+    char *expected = run_script(script->str, 1);
+    const char *first = "argument \"(P0 -> Q0), P0 => Q0\" is valid\nbetween\nargument \"(P0 | Q0) => P0\" is invalid\n";
+    if (strncmp(expected, first, strlen(first)) != 0) {
+        printf(RED "✘ Test case 1 failed: got '%.120s'\n" RESET, expected);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    const int threads[] = {2, 4, 7};
+    for (int i = 0; i < 3; i++) {
+        char *text = run_script(script->str, threads[i]);
+        if (strcmp(text, expected) != 0) {
+            printf(RED "✘ Test case %d failed: the output with %d threads differs\n" RESET, i + 2, threads[i]);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 2);
+        }
+        free(text);
+    }
+    free(expected);
+    g_string_free(script, TRUE);
+}
+
+void test_deep_truth_conditions() {
+    // ((((P & Q) | Q) -> Q) & Q) ... nested 30 levels deep
+    Wff *q = create_atomic_condition("Q");
+    Wff *wff = create_atomic_condition("P");
+    for (int i = 0; i < 30; i++) {
+        if (i % 3 == 0) {
+            wff = create_conjunction(wff, q);
+        } else if (i % 3 == 1) {
+            wff = create_disjunction(wff, q);
+        } else {
+            wff = create_conditional(wff, q);
+        }
+    }
+
+    // every subformula is visited once per polarity, hence the depth takes no exponential time, and
+    // the conditions of the wff are those of the falsehood of its negation
+    GSList *t = determine_truthness_conditions(wff);
+    GSList *f = determine_falsehood_conditions(wff);
+    GSList *n = determine_falsehood_conditions(create_negation(wff));
+    if (t == NULL || f == NULL || g_slist_length(n) != g_slist_length(t)) {
+        printf(RED "✘ Test case failed: wrong conditions\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case passed\n" RESET);
+    }
+}
+
 void test_embedded_operators() {
-    GQueue *tokens = g_queue_new();
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_atom_token("P"));
-    g_queue_push_tail(tokens, create_and_token());
-    g_queue_push_tail(tokens, create_atom_token("Q"));
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_or_token());
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_atom_token("Q"));
-    g_queue_push_tail(tokens, create_and_token());
-    g_queue_push_tail(tokens, create_atom_token("R"));
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_and_token());
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_atom_token("P"));
-    g_queue_push_tail(tokens, create_or_token());
-    g_queue_push_tail(tokens, create_atom_token("Q"));
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_and_token());
-    g_queue_push_tail(tokens, create_left_bracket_token());
-    g_queue_push_tail(tokens, create_atom_token("Q"));
-    g_queue_push_tail(tokens, create_or_token());
-    g_queue_push_tail(tokens, create_atom_token("R"));
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_right_bracket_token());
-    g_queue_push_tail(tokens, create_right_bracket_token());
+    // the tokens are added by hand, one per character of the text
+    const char *text = "(((P & Q) | (Q & R)) & ((P | Q) & (Q | R)))";
+    TokenStream *stream = create_token_stream(text);
+    for (size_t i = 0; text[i] != '\0'; i++) {
+        if (text[i] == '(') {
+            add_token(stream, TOKEN_LEFT_BRACKET, i, 1, -1);
+        } else if (text[i] == ')') {
+            add_token(stream, TOKEN_RIGHT_BRACKET, i, 1, -1);
+        } else if (text[i] == '&') {
+            add_token(stream, TOKEN_AND, i, 1, -1);
+        } else if (text[i] == '|') {
+            add_token(stream, TOKEN_OR, i, 1, -1);
+        } else if (text[i] != ' ') {
+            add_token(stream, TOKEN_ATOM, i, 1, intern_atom_span(text + i, 1));
+        }
+    }
+    end_statement(stream);
+    TokenCursor tokens = statement_cursor(stream, 0);
 
     char *error = NULL;
-    Wff *wff = parse_wff(tokens, &error);
+    Wff *wff = parse_wff(&tokens, &error);
+    free_token_stream(stream);
     if (error) {
         printf(RED "✘ Test case failed: %s\n" RESET, error);
         return;
@@ -264,6 +596,44 @@ void test_embedded_operators() {
     printf(GREEN "✔ Test case passed\n" RESET);
 }
 
+void test_evaluator() {
+    const char *p[] = {"argument a := (P -> (Q | !R))\n", "argument a := !(P & (R -> Q))\n"};
+    Wff *argument = parse_argument(p, 2, "argument a := ((P | Q) & (!R -> (P & Q)))\n");
+    Evaluator *evaluator = compile_evaluator(argument);
+    int atoms[] = {intern_atom("P"), intern_atom("Q"), intern_atom("R")};
+
+    // every assignment gives the same value as valuate
+    bool failed = false;
+    for (int bits = 0; bits < 8; bits++) {
+        Valuation *values = create_valuation();
+        for (int i = 0; i < 3; i++) {
+            set_atom_value(values, atoms[i], (bits >> i) & 1);
+        }
+        char *error = NULL;
+        failed = failed || run_evaluator(evaluator, values, &error) != valuate(argument, values, &error) || error;
+        free_valuation(values);
+    }
+    if (failed) {
+        printf(RED "✘ Test case 1 failed: wrong value\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    // a missing atom is reported as by valuate
+    Valuation *values = create_valuation();
+    set_atom_value(values, atoms[0], TRUE);
+    set_atom_value(values, atoms[1], TRUE);
+    char *error = NULL;
+    run_evaluator(evaluator, values, &error);
+    if (error == NULL || strcmp(error, "Missing symbol R") != 0) {
+        printf(RED "✘ Test case 2 failed: got '%s'\n" RESET, error);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    free_valuation(values);
+    free_evaluator(evaluator);
+}
+
 void test_is_tautology() {
     Wff *p = create_atomic_condition("P");
     Wff *not_p = create_negation(p);
@@ -536,10 +906,79 @@ void test_is_valid() {
     }
 }
 
+void test_jit() {
+    // atoms beyond the first word of a valuation, under every operator
+    const char *p[] = {"argument a := ((P -> !(Q & R)) | !(S -> (P | R)))\n",
+                       "argument a := (!(R & !S) -> ((Q | P) & !(S -> Q)))\n"};
+    Wff *argument = parse_argument(p, 1, p[1]);
+    for (int i = 0; i < 70; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "J%d", i);
+        intern_atom(name);
+    }
+    Wff *far = create_conjunction(create_atomic_condition("J69"), create_negation(create_atomic_condition("J3")));
+    add_premise_to_argument(argument, create_disjunction(far, parse_string(p[0])));
+
+    Program *program = create_program();
+    for (GSList *list = argument->premises; list != NULL; list = list->next) {
+        emit_wff(program, (Wff *) list->data);
+    }
+    emit_operator(program, OP_AND);
+    emit_wff(program, argument->wff1);
+    emit_operator(program, OP_AND);
+
+    Jit *columns = compile_jit(program, JIT_COLUMNS);
+    Jit *bits = compile_jit(program, JIT_BITS);
+    if (columns == NULL || bits == NULL) {
+        printf("Test case 1 skipped: no machine code for this architecture\n");
+        printf("Test case 2 skipped: no machine code for this architecture\n");
+        free_program(program);
+        return;
+    }
+
+    // the lanes are those of run_program
+    size_t n = program->atoms->len;
+    uint64_t column[n];
+    uint64_t stack[program->max_depth];
+    bool failed = false;
+    for (int round = 0; round < 8 && !failed; round++) {
+        for (size_t j = 0; j < n; j++) {
+            column[j] = 0x9E3779B97F4A7C15ull * (j + 1) * (round + 3);
+        }
+        failed = run_jit(columns, column) != run_program(program, column, stack);
+    }
+    if (failed) {
+        printf(RED "✘ Test case 1 failed: wrong lanes\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    // the bit of a valuation is the value of valuate
+    failed = false;
+    for (int bits_of_row = 0; bits_of_row < 1 << n && !failed; bits_of_row++) {
+        Valuation *values = create_valuation();
+        for (size_t j = 0; j < n; j++) {
+            set_atom_value(values, g_array_index(program->atoms, int, j), (bits_of_row >> j) & 1);
+        }
+        char *error = NULL;
+        failed = (bool) (run_jit(bits, values->values) & 1) != valuate(argument, values, &error) || error;
+        free_valuation(values);
+    }
+    if (failed) {
+        printf(RED "✘ Test case 2 failed: wrong value\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+
+    free_jit(columns);
+    free_jit(bits);
+    free_program(program);
+}
+
 void test_missing_symbol() {
     Wff *wff = create_negation(create_atomic_condition("P"));
-    GHashTable *values = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(values, "Q", GINT_TO_POINTER(TRUE));
+    Valuation *values = create_valuation();
+    set_atom_value(values, intern_atom("Q"), TRUE);
     char *error = NULL;
     valuate(wff, values, &error);
     if (error) {
@@ -554,6 +993,340 @@ void test_missing_symbol() {
     }
 }
 
+void test_symbols() {
+    int p = intern_atom("P");
+    int q = intern_atom("Q");
+    char *error = NULL;
+    TokenStream *stream = tokenize_string("P := true\n", &error);
+    Wff *wff = create_atomic_condition("Q");
+
+    if (p == q || intern_atom("P") != p || stream->atoms[0] != p || wff->atom != q) {
+        printf(RED "✘ Test case 1 failed: P and Q must have distinct and stable identifiers\n" RESET);
+    } else if (strcmp(atom_name(p), "P") != 0 || strcmp(wff->value, "Q") != 0) {
+        printf(RED "✘ Test case 1 failed: wrong names '%s' and '%s'\n" RESET, atom_name(p), wff->value);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+    free_token_stream(stream);
+    free_wff(wff);
+
+    // the bitsets grow with the identifiers
+    Valuation *values = create_valuation();
+    set_atom_value(values, 200, TRUE);
+    set_atom_value(values, 3, FALSE);
+    if (!has_atom_value(values, 200) || !get_atom_value(values, 200) || !has_atom_value(values, 3) ||
+        get_atom_value(values, 3) || has_atom_value(values, 4) || has_atom_value(values, 1000)) {
+        printf(RED "✘ Test case 2 failed: wrong valuation\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    free_valuation(values);
+}
+
+// true if every row of the table is the value which valuate gives to the formulae
+static bool table_matches(const TruthTable *table, GSList *formulae) {
+    for (int row = 0; row < 1 << table->n_atoms; row++) {
+        Valuation *values = create_valuation();
+        for (int j = 0; j < table->n_atoms; j++) {
+            set_atom_value(values, table->atoms[j], (row >> j) & 1);
+        }
+        bool value = true;
+        char *error = NULL;
+        for (GSList *list = formulae; list != NULL; list = list->next) {
+            value = value && valuate((Wff *) list->data, values, &error);
+        }
+        bool matches = truth_table_value(table, values) == value && error == NULL;
+        free_valuation(values);
+        if (!matches) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_truth_table() {
+    // the wffs of the parser, which are cached, over more than one word
+    Wff *a = parse_string("argument a := (((P -> Q) & ((R | !S) -> (T & !(U | V)))) | (W & !P))\n");
+    Wff *b = parse_string("argument a := ((T -> S) | !(Q & W))\n");
+    GSList *formulae = g_slist_append(g_slist_append(NULL, a), b);
+    for (int i = 0; i < 2; i++) {
+        TruthTable *table = create_truth_table(formulae);
+        if (table == NULL || table->n_atoms != 8 || table->n_words != 4 || !table_matches(table, formulae)) {
+            printf(RED "✘ Test case %d failed: wrong table\n" RESET, i + 1);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+        if (table != NULL) {
+            free_truth_table(table);
+        }
+    }
+    g_slist_free(formulae);
+
+    // the other wffs, over fewer atoms than a word has bits
+    Wff *p = create_atomic_condition("P");
+    Wff *q = create_atomic_condition("Q");
+    formulae = g_slist_append(NULL, create_conjunction(create_disjunction(p, q), create_negation(p)));
+    TruthTable *table = create_truth_table(formulae);
+    if (table == NULL || table->words[0] != 0x4 || !truth_table_satisfiable(table) || !table_matches(table, formulae)) {
+        printf(RED "✘ Test case 3 failed: wrong table\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 3 passed\n" RESET);
+    }
+    free_truth_table(table);
+
+    // a contradiction has no true row, and too many atoms have no table
+    formulae = g_slist_append(formulae, create_negation(q));
+    table = create_truth_table(formulae);
+    if (table == NULL || truth_table_satisfiable(table)) {
+        printf(RED "✘ Test case 4 failed: the contradiction is satisfiable\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 4 passed\n" RESET);
+    }
+    free_truth_table(table);
+    g_slist_free(formulae);
+
+    Wff *conjunction = NULL;
+    for (int i = 0; i < MAX_TABLE_ATOMS + 1; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "T%d", i);
+        Wff *atom = create_atomic_condition(name);
+        conjunction = conjunction == NULL ? atom : create_conjunction(conjunction, atom);
+    }
+    formulae = g_slist_append(NULL, conjunction);
+    if (create_truth_table(formulae) != NULL) {
+        printf(RED "✘ Test case 5 failed: a table of %d atoms\n" RESET, MAX_TABLE_ATOMS + 1);
+    } else {
+        printf(GREEN "✔ Test case 5 passed\n" RESET);
+    }
+    g_slist_free(formulae);
+}
+
+void test_unique_table() {
+    Wff *a = parse_string("argument a := ((P & Q) -> !R)\n");
+    Wff *b = parse_string("argument a := ((P & Q) -> !R)\n");
+    Wff *c = parse_string("argument a := ((Q & P) -> !R)\n");
+    Wff *d = parse_string("argument a := ((P -> Q) & !R)\n");
+
+    // equal wffs are the same node, and commuted operands only share the canonical identifier
+    if (a != b || a->wff1 != b->wff1 || a == c || a->id != c->id || a->id == d->id) {
+        printf(RED "✘ Test case 1 failed: wrong sharing\n" RESET);
+    } else if (strcmp(wff_to_string(c), "((Q & P) -> !R)") != 0) {
+        printf(RED "✘ Test case 1 failed: got '%s'\n" RESET, wff_to_string(c));
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    // the premises of an argument are a set
+    Wff *x = create_argument();
+    add_premise_to_argument(x, a);
+    add_premise_to_argument(x, d);
+    x->wff1 = d->wff2;
+    Wff *y = create_argument();
+    add_premise_to_argument(y, d);
+    add_premise_to_argument(y, c);
+    add_premise_to_argument(y, d);
+    y->wff1 = d->wff2;
+    char *kx = argument_key(x);
+    char *ky = argument_key(y);
+    if (kx == NULL || ky == NULL || strcmp(kx, ky) != 0) {
+        printf(RED "✘ Test case 2 failed: different keys '%s' and '%s'\n" RESET, kx, ky);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    free(kx);
+    free(ky);
+}
+
+void test_simplify() {
+    const char *lines[] = {
+            "argument a := !!P\n",
+            "argument a := (P & P)\n",
+            "argument a := (P | (P & Q))\n",
+            "argument a := ((Q | P) & P)\n",
+            "argument a := !(P & !Q)\n",
+            "argument a := (P -> Q)\n",
+            "argument a := ((P -> P) & Q)\n",
+            "argument a := ((P & !P) | (Q & Q))\n",
+            "argument a := (P -> P)\n",
+            "argument a := (!(Q | P) & P)\n"
+    };
+    const char *expected[] = {"P", "P", "P", "P", "(!P | Q)", "(!P | Q)", "Q", "Q", "true", "false"};
+
+    for (int i = 0; i < 10; i++) {
+        bool value;
+        Wff *wff = simplify_wff(parse_string(lines[i]), &value);
+        const char *got = wff != NULL ? wff_to_string(wff) : value ? "true" : "false";
+        if (strcmp(got, expected[i]) != 0) {
+            printf(RED "✘ Test case %d failed: expected '%s', got '%s'\n" RESET, i + 1, expected[i], got);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+    }
+}
+
+// a linear congruential generator, hence the formulae are the same in every run
+static unsigned int next_random(unsigned int *state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFF;
+}
+
+// appends a random wff over the atoms P0 to P13, of at most the given depth
+static void append_random_wff(GString *str, int depth, unsigned int *state) {
+    unsigned int r = next_random(state);
+    if (depth == 0 || r % 4 == 0) {
+        g_string_append_printf(str, "P%u", (r >> 2) % 14);
+    } else if (r % 4 == 1) {
+        g_string_append_c(str, '!');
+        append_random_wff(str, depth - 1, state);
+    } else {
+        const char *operators[] = {" & ", " | ", " -> "};
+        g_string_append_c(str, '(');
+        append_random_wff(str, depth - 1, state);
+        g_string_append(str, operators[(r >> 2) % 3]);
+        append_random_wff(str, depth - 1, state);
+        g_string_append_c(str, ')');
+    }
+}
+
+// parses a random wff
+static Wff *random_wff(unsigned int *state) {
+    GString *line = g_string_new("argument a := ");
+    append_random_wff(line, 6, state);
+    g_string_append_c(line, '\n');
+    Wff *wff = parse_string(line->str);
+    g_string_free(line, TRUE);
+    return wff;
+}
+
+void test_solver_session() {
+    Wff *premises[] = {
+            parse_string("argument a := (P -> Q)\n"),
+            parse_string("argument a := (Q -> R)\n"),
+            parse_string("argument a := P\n")
+    };
+    const char *conclusions[] = {"argument a := R\n", "argument a := !R\n", "argument a := (R & Q)\n",
+                                 "argument a := S\n", "argument a := (Q & R)\n"};
+    bool expected[] = {TRUE, FALSE, TRUE, FALSE, TRUE};
+
+    // the arguments share their premises, which the solver of the session encodes once
+    set_engine(ENGINE_SAT);
+    for (int i = 0; i < 5; i++) {
+        Wff *argument = create_argument();
+        for (int j = 0; j < 3; j++) {
+            add_premise_to_argument(argument, premises[j]);
+        }
+        argument->wff1 = parse_string(conclusions[i]);
+
+        char *error = NULL;
+        if (is_valid(argument, &error) != expected[i]) {
+            printf(RED "✘ Test case %d failed: expected %s\n" RESET, i + 1, expected[i] ? "valid" : "invalid");
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+        }
+    }
+    end_solver_session();
+
+    // many arguments in a single session, whose verdicts are those of the truth table, whatever
+    // the solver learnt from the previous ones
+    const int n_arguments = 1000;
+    unsigned int state = 7;
+    int wrong = 0;
+    for (int i = 0; i < n_arguments; i++) {
+        Wff *argument = create_argument();
+        for (int j = 0; j < 6; j++) {
+            add_premise_to_argument(argument, random_wff(&state));
+        }
+        argument->wff1 = random_wff(&state);
+
+        char *error = NULL;
+        set_engine(ENGINE_SAT);
+        bool incremental = is_valid(argument, &error);
+        set_engine(ENGINE_TRUTH_TABLE);
+        bool table = is_valid(argument, &error);
+        wrong += incremental != table || error != NULL;
+    }
+    if (wrong > 0) {
+        printf(RED "✘ Test case 6 failed: %d of %d verdicts differ from the truth table\n" RESET, wrong, n_arguments);
+    } else {
+        printf(GREEN "✔ Test case 6 passed\n" RESET);
+    }
+    end_solver_session();
+    set_engine(ENGINE_AUTO);
+}
+
+void test_verdict_cache() {
+    const char *path = "test_verdict_cache.bin";
+    const char *p[] = {"argument a := (P -> Q)\n", "argument a := (P & R)\n"};
+    const char *x[] = {"argument a := (Y & X)\n", "argument a := (X -> Z)\n"};
+    Wff *a = parse_argument(p, 2, "argument a := (Q | R)\n");
+    Wff *b = parse_argument(x, 2, "argument a := (Y | Z)\n");
+    Wff *c = parse_argument(x, 2, "argument a := (Y -> Z)\n");
+
+    // renamed atoms, commuted operands and reordered premises give the same canonical form
+    char *ka = canonical_argument("v", a);
+    char *kb = canonical_argument("v", b);
+    char *kc = canonical_argument("v", c);
+    if (strcmp(ka, kb) != 0 || strcmp(ka, kc) == 0) {
+        printf(RED "✘ Test case 1 failed: got '%s', '%s' and '%s'\n" RESET, ka, kb, kc);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+    g_free(ka);
+    g_free(kb);
+    g_free(kc);
+
+    // the verdicts survive the cache file being closed
+    unlink(path);
+    char *error = NULL;
+    bool verdict = FALSE;
+    if (!open_verdict_cache(path, &error) || lookup_verdict("v", a, &verdict)) {
+        printf(RED "✘ Test case 2 failed: the new cache is not empty\n" RESET);
+    } else {
+        store_verdict("v", a, TRUE);
+        close_verdict_cache();
+        open_verdict_cache(path, &error);
+        if (!lookup_verdict("v", b, &verdict) || !verdict || lookup_verdict("t", b, &verdict) ||
+            lookup_verdict("v", c, &verdict)) {
+            printf(RED "✘ Test case 2 failed: wrong lookups\n" RESET);
+        } else {
+            printf(GREEN "✔ Test case 2 passed\n" RESET);
+        }
+    }
+    close_verdict_cache();
+    unlink(path);
+
+    // a file which is not a cache, either of another size or of the size of a cache, is refused
+    // and left as it is
+    // a cache is a header of 16 bytes, and slots of 32 bytes
+    const size_t sizes[] = {64, 16 + VERDICT_CACHE_SLOTS * 32};
+    for (int i = 0; i < 2; i++) {
+        char *content = malloc(sizes[i]);
+        for (size_t k = 0; k < sizes[i]; k++) {
+            content[k] = (char) ('a' + k % 26);
+        }
+        FILE *file = fopen(path, "w");
+        fwrite(content, 1, sizes[i], file);
+        fclose(file);
+
+        error = NULL;
+        bool opened = open_verdict_cache(path, &error);
+        close_verdict_cache();
+        char *after = calloc(sizes[i] + 1, 1);
+        file = fopen(path, "r");
+        size_t n = fread(after, 1, sizes[i] + 1, file);
+        fclose(file);
+        if (opened || error == NULL || n != sizes[i] || memcmp(content, after, sizes[i]) != 0) {
+            printf(RED "✘ Test case %d failed: the file was %s\n" RESET, i + 3, opened ? "opened" : "changed");
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i + 3);
+        }
+        free(error);
+        free(content);
+        free(after);
+        unlink(path);
+    }
+}
+
 void test_valuation() {
     Wff *p = create_atomic_condition("P");
     Wff *not_p = create_negation(p);
@@ -571,31 +1344,31 @@ void test_valuation() {
 
     // !P with P true
     test_cases[i].wff = not_p;
-    test_cases[i].values = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(test_cases[i].values, g_strdup("P"), GINT_TO_POINTER(TRUE));
+    test_cases[i].values = create_valuation();
+    set_atom_value(test_cases[i].values, intern_atom("P"), TRUE);
     test_cases[i].result = FALSE;
 
     // !P with P false
     i++;
     test_cases[i].wff = not_p;
-    test_cases[i].values = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(test_cases[i].values, g_strdup("P"), GINT_TO_POINTER(FALSE));
+    test_cases[i].values = create_valuation();
+    set_atom_value(test_cases[i].values, intern_atom("P"), FALSE);
     test_cases[i].result = TRUE;
 
     // !P | !Q with P true and Q false
     i++;
     test_cases[i].wff = dis_not_p_not_q;
-    test_cases[i].values = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(test_cases[i].values, g_strdup("P"), GINT_TO_POINTER(TRUE));
-    g_hash_table_insert(test_cases[i].values, g_strdup("Q"), GINT_TO_POINTER(FALSE));
+    test_cases[i].values = create_valuation();
+    set_atom_value(test_cases[i].values, intern_atom("P"), TRUE);
+    set_atom_value(test_cases[i].values, intern_atom("Q"), FALSE);
     test_cases[i].result = TRUE;
 
     // !P | !Q with P true and Q true
     i++;
     test_cases[i].wff = dis_not_p_not_q;
-    test_cases[i].values = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(test_cases[i].values, g_strdup("P"), GINT_TO_POINTER(TRUE));
-    g_hash_table_insert(test_cases[i].values, g_strdup("Q"), GINT_TO_POINTER(TRUE));
+    test_cases[i].values = create_valuation();
+    set_atom_value(test_cases[i].values, intern_atom("P"), TRUE);
+    set_atom_value(test_cases[i].values, intern_atom("Q"), TRUE);
     test_cases[i].result = FALSE;
 
     for (i = 0; i < num_tests; i++) {
@@ -617,3 +1390,170 @@ void test_valuation() {
         printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
     }
 }
+
+void test_is_valid_many_atoms() {
+    const int n_atoms = 10;
+    Wff *atoms[n_atoms];
+    for (int i = 0; i < n_atoms; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "P%d", i + 1);
+        atoms[i] = create_atomic_condition(name);
+    }
+
+    const int num_tests = 3;
+
+    BTestCase test_cases[num_tests];
+
+    int i = 0;
+
+    // P1, (P1 → P2), ..., (P9 → P10) ∴ P10
+    test_cases[i].argument = create_argument();
+    test_cases[i].argument->wff1 = atoms[n_atoms - 1];
+    test_cases[i].argument->premises = g_slist_append(
+            test_cases[i].argument->premises, atoms[0]);
+    for (int j = 1; j < n_atoms; j++) {
+        test_cases[i].argument->premises = g_slist_append(
+                test_cases[i].argument->premises,
+                create_conditional(atoms[j - 1], atoms[j]));
+    }
+    test_cases[i].result = TRUE;
+
+    // (P1 → P2), ..., (P9 → P10) ∴ P10
+    i++;
+    test_cases[i].argument = create_argument();
+    test_cases[i].argument->wff1 = atoms[n_atoms - 1];
+    for (int j = 1; j < n_atoms; j++) {
+        test_cases[i].argument->premises = g_slist_append(
+                test_cases[i].argument->premises,
+                create_conditional(atoms[j - 1], atoms[j]));
+    }
+    test_cases[i].result = FALSE;
+
+    // (P1 ∧ ... ∧ P10) ∴ ¬(¬P10 ∨ ¬P7)
+    i++;
+    test_cases[i].argument = create_argument();
+    Wff *conjunction = atoms[0];
+    for (int j = 1; j < n_atoms; j++) {
+        conjunction = create_conjunction(conjunction, atoms[j]);
+    }
+    test_cases[i].argument->wff1 = create_negation(
+            create_disjunction(create_negation(atoms[9]),
+                               create_negation(atoms[6])));
+    test_cases[i].argument->premises = g_slist_append(
+            test_cases[i].argument->premises, conjunction);
+    test_cases[i].result = TRUE;
+
+    for (i = 0; i < num_tests; i++) {
+        char *error = NULL;
+        bool b = is_valid(test_cases[i].argument, &error);
+        if (error) {
+            printf(RED "✘ Test case %d failed: %s\n" RESET, i + 1, error);
+            free(error);
+            continue;
+        }
+        if (test_cases[i].result != b) {
+            printf(RED "✘ Test case %d failed: expected '%s', got '%s'\n" RESET,
+                   i + 1,
+                   test_cases[i].result ? "true" : "false",
+                   b ? "true" : "false");
+            continue;
+        }
+
+        printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+    }
+}
+
+void test_sweep_kernels() {
+    // the conjunction of P1, !P2, P3, ... has exactly one satisfying row
+    const int n_atoms = 12;
+    Wff *conjunction = NULL;
+    uint64_t expected = 0;
+    for (int i = 0; i < n_atoms; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "P%d", i + 1);
+        Wff *literal = create_atomic_condition(name);
+        if (i % 3 == 1) {
+            literal = create_negation(literal);
+        } else {
+            expected |= 1ULL << i;
+        }
+        conjunction = conjunction == NULL ? literal : create_conjunction(conjunction, literal);
+    }
+
+    Program *program = create_program();
+    emit_wff(program, conjunction);
+
+    const SweepKernel kernels[] = {SWEEP_SCALAR, SWEEP_AVX2, SWEEP_AVX512};
+    const char *names[] = {"scalar", "AVX2", "AVX-512"};
+    SweepKernel current = get_sweep_kernel();
+
+    for (int i = 0; i < 3; i++) {
+        if (!set_sweep_kernel(kernels[i])) {
+            printf("Test case %d skipped: the %s kernel is not supported\n", i + 1, names[i]);
+            continue;
+        }
+        uint64_t row = 0;
+        if (!sweep_program(program, &row)) {
+            printf(RED "✘ Test case %d failed: the %s kernel found no row\n" RESET, i + 1, names[i]);
+            continue;
+        }
+        if (row != expected) {
+            printf(RED "✘ Test case %d failed: the %s kernel found row %llu, expected %llu\n" RESET,
+                   i + 1, names[i], (unsigned long long) row, (unsigned long long) expected);
+            continue;
+        }
+        printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+    }
+
+    set_sweep_kernel(current);
+    free_program(program);
+}
+
+void test_sweep_threads() {
+    // the conjunction of P1, !P2, P3, ... has exactly one satisfying row, far enough to be
+    // found by a thread other than the first one
+    const int n_atoms = 20;
+    Wff *conjunction = NULL;
+    uint64_t expected = 0;
+    for (int i = 0; i < n_atoms; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "P%d", i + 1);
+        Wff *literal = create_atomic_condition(name);
+        if (i % 3 == 1) {
+            literal = create_negation(literal);
+        } else {
+            expected |= 1ULL << i;
+        }
+        conjunction = conjunction == NULL ? literal : create_conjunction(conjunction, literal);
+    }
+
+    Program *program = create_program();
+    emit_wff(program, conjunction);
+
+    const int threads[] = {1, 2, 4, 7};
+    int current = get_sweep_threads();
+
+    for (int i = 0; i < 4; i++) {
+        set_sweep_threads(threads[i]);
+        uint64_t row = 0;
+        if (!sweep_program(program, &row) || row != expected) {
+            printf(RED "✘ Test case %d failed: expected row %llu with %d threads\n" RESET,
+                   i + 1, (unsigned long long) expected, threads[i]);
+            continue;
+        }
+        printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+    }
+
+    // the negation is true in every other row
+    emit_operator(program, OP_NOT);
+    set_sweep_threads(4);
+    uint64_t row = 0;
+    if (!sweep_program(program, &row) || row == expected) {
+        printf(RED "✘ Test case 5 failed: expected a row other than %llu\n" RESET, (unsigned long long) expected);
+    } else {
+        printf(GREEN "✔ Test case 5 passed\n" RESET);
+    }
+
+    set_sweep_threads(current);
+    free_program(program);
+}
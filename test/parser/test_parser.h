@@ -1,16 +1,50 @@
 #ifndef ARIS_PL_TEST_PARSER_H
 #define ARIS_PL_TEST_PARSER_H
 
+void test_components();
+
+void test_count();
+
+void test_deep_truth_conditions();
+
 void test_determine_truth_conditions();
 
+void test_dimacs();
+
+void test_load_dimacs();
+
 void test_embedded_operators();
 
+void test_evaluator();
+
 void test_is_tautology();
 
 void test_is_valid();
 
+void test_is_valid_many_atoms();
+
+void test_jit();
+
 void test_missing_symbol();
 
+void test_parallel_statements();
+
+void test_simplify();
+
+void test_solver_session();
+
+void test_sweep_kernels();
+
+void test_sweep_threads();
+
+void test_symbols();
+
+void test_truth_table();
+
+void test_unique_table();
+
 void test_valuation();
 
+void test_verdict_cache();
+
 #endif //ARIS_PL_TEST_PARSER_H
@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cnf.h"
+#include "sat.h"
+
+#define GREEN   "\x1b[32m"
+#define RED     "\x1b[31m"
+#define RESET   "\x1b[0m"
+
+// the variable which is true if the pigeon p sits in the hole h
+static int pigeon(int p, int h, int holes) {
+    return p * holes + h + 1;
+}
+
+// adds the clauses stating that the pigeons sit in distinct holes
+static void add_pigeonhole(Solver *solver, int pigeons, int holes) {
+    for (int i = 0; i < pigeons * holes; i++) {
+        solver_new_var(solver);
+    }
+    int *clause = malloc(holes * sizeof(int));
+    for (int p = 0; p < pigeons; p++) {
+        for (int h = 0; h < holes; h++) {
+            clause[h] = pigeon(p, h, holes);
+        }
+        solver_add_clause(solver, clause, holes);
+    }
+    free(clause);
+    for (int h = 0; h < holes; h++) {
+        for (int p = 0; p < pigeons; p++) {
+            for (int q = p + 1; q < pigeons; q++) {
+                int c[] = {-pigeon(p, h, holes), -pigeon(q, h, holes)};
+                solver_add_clause(solver, c, 2);
+            }
+        }
+    }
+}
+
+// a linear congruential generator, hence the instances are the same in every run
+static unsigned int next_random(unsigned int *state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 16) & 0x7FFF;
+}
+
+// returns true if the assignment, whose bit v - 1 is the value of the variable v, satisfies the
+// clauses, which have three literals each
+static bool satisfies(const int *clauses, int n_clauses, unsigned int assignment) {
+    for (int c = 0; c < n_clauses; c++) {
+        bool satisfied = false;
+        for (int k = 0; k < 3 && !satisfied; k++) {
+            int lit = clauses[3 * c + k];
+            bool value = (assignment >> (abs(lit) - 1)) & 1;
+            satisfied = lit > 0 ? value : !value;
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// checks random 3-SAT around the threshold, where about half of the instances are satisfiable,
+// and the same instances under random assumptions, against an exhaustive search, as the two
+// test cases after the i-th one
+static void check_random_instances(int i) {
+    const int n_vars = 12;
+    const int n_clauses = 52;
+    const int n_instances = 3000;
+    unsigned int state = 2025;
+    int clauses[3 * 52];
+    int wrong = 0;
+    int wrong_assuming = 0;
+    for (int t = 0; t < n_instances; t++) {
+        for (int k = 0; k < 3 * n_clauses; k++) {
+            int v = (int) (next_random(&state) % n_vars) + 1;
+            clauses[k] = next_random(&state) & 1 ? v : -v;
+        }
+        int assumptions[2];
+        for (int k = 0; k < 2; k++) {
+            int v = (int) (next_random(&state) % n_vars) + 1;
+            assumptions[k] = next_random(&state) & 1 ? v : -v;
+        }
+
+        bool expected = false;
+        bool expected_assuming = false;
+        for (unsigned int a = 0; a < (1u << n_vars); a++) {
+            if (satisfies(clauses, n_clauses, a)) {
+                expected = true;
+                bool holds = true;
+                for (int k = 0; k < 2; k++) {
+                    bool value = (a >> (abs(assumptions[k]) - 1)) & 1;
+                    holds = holds && (assumptions[k] > 0 ? value : !value);
+                }
+                expected_assuming = expected_assuming || holds;
+            }
+        }
+
+        Solver *solver = create_solver();
+        for (int v = 0; v < n_vars; v++) {
+            solver_new_var(solver);
+        }
+        bool trivial = false;
+        for (int c = 0; c < n_clauses; c++) {
+            trivial = !solver_add_clause(solver, clauses + 3 * c, 3) || trivial;
+        }
+        // the solve under the assumptions comes first, hence the other one reuses what it learnt
+        bool sat_assuming = !trivial && solver_solve_assuming(solver, assumptions, 2);
+        bool sat = !trivial && solver_solve(solver);
+        if (sat) {
+            unsigned int model = 0;
+            for (int v = 1; v <= n_vars; v++) {
+                model |= (unsigned int) solver_model_value(solver, v) << (v - 1);
+            }
+            sat = satisfies(clauses, n_clauses, model);
+        }
+        wrong += sat != expected;
+        wrong_assuming += sat_assuming != expected_assuming;
+        free_solver(solver);
+    }
+
+    if (wrong > 0) {
+        printf(RED "✘ Test case %d failed: %d of %d instances decided wrongly\n" RESET, i + 1, wrong, n_instances);
+    } else {
+        printf(GREEN "✔ Test case %d passed\n" RESET, i + 1);
+    }
+    if (wrong_assuming > 0) {
+        printf(RED "✘ Test case %d failed: %d of %d instances decided wrongly under assumptions\n" RESET,
+               i + 2, wrong_assuming, n_instances);
+    } else {
+        printf(GREEN "✔ Test case %d passed\n" RESET, i + 2);
+    }
+}
+
+void test_solver() {
+    int i = 0;
+
+    // 7 pigeons cannot sit in 6 holes
+    i++;
+    Solver *solver = create_solver();
+    add_pigeonhole(solver, 7, 6);
+    if (solver_solve(solver)) {
+        printf(RED "✘ Test case %d failed: expected unsatisfiable\n" RESET, i);
+    } else {
+        printf(GREEN "✔ Test case %d passed\n" RESET, i);
+    }
+    free_solver(solver);
+
+    // 6 pigeons can sit in 6 holes, one per hole
+    i++;
+    solver = create_solver();
+    add_pigeonhole(solver, 6, 6);
+    if (!solver_solve(solver)) {
+        printf(RED "✘ Test case %d failed: expected satisfiable\n" RESET, i);
+    } else {
+        bool failed = false;
+        for (int h = 0; h < 6; h++) {
+            int n = 0;
+            for (int p = 0; p < 6; p++) {
+                n += solver_model_value(solver, pigeon(p, h, 6));
+            }
+            failed = failed || n != 1;
+        }
+        if (failed) {
+            printf(RED "✘ Test case %d failed: the model is wrong\n" RESET, i);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i);
+        }
+    }
+    free_solver(solver);
+
+    // the empty clause
+    i++;
+    solver = create_solver();
+    solver_new_var(solver);
+    int unit[] = {1};
+    int negated_unit[] = {-1};
+    solver_add_clause(solver, unit, 1);
+    if (solver_add_clause(solver, negated_unit, 1) || solver_solve(solver)) {
+        printf(RED "✘ Test case %d failed: expected unsatisfiable\n" RESET, i);
+    } else {
+        printf(GREEN "✔ Test case %d passed\n" RESET, i);
+    }
+    free_solver(solver);
+
+    // the assumptions hold only during one solve
+    i++;
+    solver = create_solver();
+    add_pigeonhole(solver, 3, 3);
+    int assumptions[] = {pigeon(0, 0, 3), pigeon(1, 0, 3)};
+    bool failed = solver_solve_assuming(solver, assumptions, 2);
+    failed = failed || !solver_solve_assuming(solver, assumptions, 1) || !solver_model_value(solver, assumptions[0]);
+    failed = failed || !solver_solve(solver);
+    if (failed) {
+        printf(RED "✘ Test case %d failed: wrong solves under assumptions\n" RESET, i);
+    } else {
+        printf(GREEN "✔ Test case %d passed\n" RESET, i);
+    }
+    free_solver(solver);
+    check_random_instances(i);
+}
+
+void test_tseitin() {
+    Wff *p = create_atomic_condition("P");
+    Wff *q = create_atomic_condition("Q");
+
+    // (P -> Q) & P & !Q
+    Cnf *cnf = create_cnf();
+    int roots[] = {
+            encode_wff(cnf, create_conditional(p, q)),
+            encode_wff(cnf, p),
+            encode_wff(cnf, create_negation(q))
+    };
+    for (int i = 0; i < 3; i++) {
+        add_clause(cnf, &roots[i], 1);
+    }
+
+    if (cnf->n_vars != 3 || cnf->n_clauses != 6) {
+        printf(RED "✘ Test case 1 failed: expected 3 variables and 6 clauses, got %d and %zu\n" RESET,
+               cnf->n_vars, cnf->n_clauses);
+    } else {
+        printf(GREEN "✔ Test case 1 passed\n" RESET);
+    }
+
+    Solver *solver = create_solver();
+    if (load_cnf(solver, cnf) && solver_solve(solver)) {
+        printf(RED "✘ Test case 2 failed: expected unsatisfiable\n" RESET);
+    } else {
+        printf(GREEN "✔ Test case 2 passed\n" RESET);
+    }
+    free_solver(solver);
+    free_cnf(cnf);
+}
@@ -0,0 +1,8 @@
+#ifndef ARIS_PL_TEST_SAT_H
+#define ARIS_PL_TEST_SAT_H
+
+void test_solver();
+
+void test_tseitin();
+
+#endif //ARIS_PL_TEST_SAT_H
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include "tableau.h"
+#include "wff.h"
+
+#define GREEN   "\x1b[32m"
+#define RED     "\x1b[31m"
+#define RESET   "\x1b[0m"
+
+#define N 12
+
+// (A0 | B0) & ... & (A11 | B11), whose disjunctions all branch, together with the formulae
+// stating that the last disjunction implies C
+static GSList *create_disjunctions(bool c) {
+    char name[8];
+    GSList *formulae = NULL;
+    Wff *a = NULL;
+    Wff *b = NULL;
+    for (int i = 0; i < N; i++) {
+        snprintf(name, sizeof(name), "TA%d", i);
+        a = create_atomic_condition(name);
+        snprintf(name, sizeof(name), "TB%d", i);
+        b = create_atomic_condition(name);
+        formulae = g_slist_append(formulae, create_disjunction(a, b));
+    }
+    Wff *wff = create_atomic_condition("TC");
+    formulae = g_slist_append(formulae, create_conditional(a, wff));
+    formulae = g_slist_append(formulae, create_conditional(b, wff));
+    formulae = g_slist_append(formulae, c ? wff : create_negation(wff));
+    return formulae;
+}
+
+void test_tableau() {
+    int i = 0;
+    int threads[] = {1, 4};
+    for (int t = 0; t < 2; t++) {
+        GSList *formulae = create_disjunctions(false);
+        i++;
+        if (tableau_satisfiable(formulae, threads[t])) {
+            printf(RED "✘ Test case %d failed: expected a closed tree with %d threads\n" RESET, i, threads[t]);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i);
+        }
+        g_slist_free(formulae);
+
+        formulae = create_disjunctions(true);
+        i++;
+        if (!tableau_satisfiable(formulae, threads[t])) {
+            printf(RED "✘ Test case %d failed: expected an open tree with %d threads\n" RESET, i, threads[t]);
+        } else {
+            printf(GREEN "✔ Test case %d passed\n" RESET, i);
+        }
+        g_slist_free(formulae);
+    }
+}
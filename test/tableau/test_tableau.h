@@ -0,0 +1,6 @@
+#ifndef ARIS_PL_TEST_TABLEAU_H
+#define ARIS_PL_TEST_TABLEAU_H
+
+void test_tableau();
+
+#endif //ARIS_PL_TEST_TABLEAU_H
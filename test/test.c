@@ -1,6 +1,10 @@
 #include <printf.h>
 #include "lexical_analyzer/test_lexical_analizer.h"
 #include "parser/test_parser.h"
+#include "bdd/test_bdd.h"
+#include "sat/test_sat.h"
+#include "tableau/test_tableau.h"
+#include "engine.h"
 
 int main() {
     printf("Running test_tokenize\n");
@@ -9,9 +13,24 @@ int main() {
     printf("\nRunning test_tokenize_fails\n");
     test_tokenize_fails();
 
+    printf("\nRunning test_tokenize_keywords\n");
+    test_tokenize_keywords();
+
+    printf("\nRunning test_tokenize_kernels\n");
+    test_tokenize_kernels();
+
+    printf("\nRunning test_tokenize_arena\n");
+    test_tokenize_arena();
+
+    printf("\nRunning test_tokenize_source\n");
+    test_tokenize_source();
+
     printf("\nRunning test_determine_truth_conditions\n");
     test_determine_truth_conditions();
 
+    printf("\nRunning test_deep_truth_conditions\n");
+    test_deep_truth_conditions();
+
     printf("\nRunning test_embedded_operators\n");
     test_embedded_operators();
 
@@ -24,6 +43,96 @@ int main() {
     printf("\nRunning test_is_valid\n");
     test_is_valid();
 
+    printf("\nRunning test_is_tautology with the SAT engine\n");
+    set_engine(ENGINE_SAT);
+    test_is_tautology();
+
+    printf("\nRunning test_is_valid with the SAT engine\n");
+    test_is_valid();
+    set_engine(ENGINE_AUTO);
+
+    printf("\nRunning test_is_tautology with the BDD engine\n");
+    set_engine(ENGINE_BDD);
+    test_is_tautology();
+
+    printf("\nRunning test_is_valid with the BDD engine\n");
+    test_is_valid();
+    set_engine(ENGINE_AUTO);
+
+    printf("\nRunning test_is_tautology with the tableau engine\n");
+    set_engine(ENGINE_TABLEAU);
+    test_is_tautology();
+
+    printf("\nRunning test_is_valid with the tableau engine\n");
+    test_is_valid();
+    set_engine(ENGINE_AUTO);
+
+    printf("\nRunning test_bdd\n");
+    test_bdd();
+
+    printf("\nRunning test_bdd_gc\n");
+    test_bdd_gc();
+
+    printf("\nRunning test_bdd_pool\n");
+    test_bdd_pool();
+
+    printf("\nRunning test_solver\n");
+    test_solver();
+
+    printf("\nRunning test_tseitin\n");
+    test_tseitin();
+
+    printf("\nRunning test_tableau\n");
+    test_tableau();
+
+    printf("\nRunning test_is_valid_many_atoms\n");
+    test_is_valid_many_atoms();
+
+    printf("\nRunning test_jit\n");
+    test_jit();
+
+    printf("\nRunning test_sweep_kernels\n");
+    test_sweep_kernels();
+
+    printf("\nRunning test_sweep_threads\n");
+    test_sweep_threads();
+
+    printf("\nRunning test_components\n");
+    test_components();
+
+    printf("\nRunning test_count\n");
+    test_count();
+
+    printf("\nRunning test_dimacs\n");
+    test_dimacs();
+
+    printf("\nRunning test_load_dimacs\n");
+    test_load_dimacs();
+
+    printf("\nRunning test_parallel_statements\n");
+    test_parallel_statements();
+
+    printf("\nRunning test_simplify\n");
+    test_simplify();
+
+    printf("\nRunning test_solver_session\n");
+    test_solver_session();
+
+    printf("\nRunning test_symbols\n");
+    test_symbols();
+
+    printf("\nRunning test_truth_table\n");
+    test_truth_table();
+
+    printf("\nRunning test_unique_table\n");
+    test_unique_table();
+
     printf("\nRunning test_valuation\n");
     test_valuation();
+
+    printf("\nRunning test_evaluator\n");
+    test_evaluator();
+
+    printf("\nRunning test_verdict_cache\n");
+    test_verdict_cache();
 }